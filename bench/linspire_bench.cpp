@@ -0,0 +1,265 @@
+#include "linspire.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+// we count the allocations performed by the whole program..
+static std::atomic<std::size_t> n_allocs{0}, allocated_bytes{0};
+
+void *operator new(std::size_t size)
+{
+    ++n_allocs;
+    allocated_bytes += size;
+    if (void *ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+struct scenario_result
+{
+    std::size_t n_vars = 0, n_constraints = 0, n_checks = 0;
+    bool sat = true;
+    json::json stats;  // the statistics of the solver, if enabled..
+    json::json memory; // the memory footprint of the solver..
+};
+
+static void collect_stats(scenario_result &res, const linspire::solver &s)
+{
+    res.memory = to_json(s.memory_usage());
+#ifdef LINSPIRE_ENABLE_STATISTICS
+    res.stats = to_json(s.stats());
+#endif
+}
+
+/**
+ * Random sparse constraints `a * x <= b` over `n` variables, each involving `k` variables, all satisfied by a hidden point.
+ */
+static scenario_result random_sparse_lp(std::mt19937 &rng, const std::size_t n, const std::size_t m, const std::size_t k)
+{
+    scenario_result res;
+    linspire::solver s;
+    std::vector<utils::var> xs;
+    std::vector<int> point;
+    std::uniform_int_distribution<int> val_dist(-10, 10), coeff_dist(-2, 2), slack_dist(0, 5);
+    std::uniform_int_distribution<std::size_t> var_dist(0, n - 1);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        xs.push_back(s.new_var());
+        point.push_back(val_dist(rng));
+    }
+    std::deque<linspire::constraint> cs;
+    for (std::size_t j = 0; j < m; ++j)
+    {
+        utils::lin l;
+        int b = slack_dist(rng);
+        for (std::size_t t = 0; t < k; ++t)
+            if (const auto c = coeff_dist(rng); c != 0)
+                if (const auto i = var_dist(rng); l.vars.emplace(xs[i], c).second)
+                    b += c * point[i];
+        if (l.vars.empty())
+            continue;
+        res.sat &= s.new_lt(l, b, false, cs.emplace_back());
+    }
+    ++res.n_checks;
+    res.sat &= s.check();
+    res.n_vars = n;
+    res.n_constraints = cs.size();
+    collect_stats(res, s);
+    return res;
+}
+
+/**
+ * Difference constraints modelling `n` chains of `len` tasks with random durations, whose end must not exceed a common horizon.
+ */
+static scenario_result scheduling_chains(std::mt19937 &rng, const std::size_t n, const std::size_t len)
+{
+    scenario_result res;
+    linspire::solver s;
+    std::uniform_int_distribution<int> dur_dist(1, 10);
+    std::deque<linspire::constraint> cs;
+    const auto origin = s.new_var();
+    res.sat &= s.new_eq({{origin, 1}}, 0, cs.emplace_back());
+    std::vector<utils::var> ends;
+    for (std::size_t c = 0; c < n; ++c)
+    {
+        auto prev = origin;
+        for (std::size_t t = 0; t < len; ++t)
+        { // the start of each task follows the end of the previous one..
+            const auto start = s.new_var();
+            res.sat &= s.new_gt({{start, 1}, {prev, -1}}, dur_dist(rng), false, cs.emplace_back());
+            prev = start;
+        }
+        ends.push_back(prev);
+    }
+    for (const auto &e : ends)
+        res.sat &= s.new_lt({{e, 1}, {origin, -1}}, static_cast<int>(len) * 11, false, cs.emplace_back());
+    ++res.n_checks;
+    res.sat &= s.check();
+    res.n_vars = 1 + n * len;
+    res.n_constraints = cs.size();
+    collect_stats(res, s);
+    return res;
+}
+
+/**
+ * A block of `m` dense equalities over `n` variables, all satisfied by a hidden point.
+ */
+static scenario_result dense_equalities(std::mt19937 &rng, const std::size_t n, const std::size_t m)
+{
+    scenario_result res;
+    linspire::solver s;
+    std::vector<utils::var> xs;
+    std::vector<int> point;
+    std::uniform_int_distribution<int> val_dist(-10, 10), coeff_dist(1, 9);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        xs.push_back(s.new_var());
+        point.push_back(val_dist(rng));
+    }
+    std::deque<linspire::constraint> cs;
+    for (std::size_t i = 0; i < n; ++i)
+    { // we bound the variables around the hidden point..
+        res.sat &= s.new_gt({{xs[i], 1}}, point[i] - 20, false, cs.emplace_back());
+        res.sat &= s.new_lt({{xs[i], 1}}, point[i] + 20, false, cs.emplace_back());
+    }
+    for (std::size_t j = 0; j < m; ++j)
+    {
+        utils::lin l;
+        int b = 0;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            const auto c = coeff_dist(rng);
+            l.vars.emplace(xs[i], c);
+            b += c * point[i];
+        }
+        res.sat &= s.new_eq(l, b, cs.emplace_back());
+    }
+    ++res.n_checks;
+    res.sat &= s.check();
+    res.n_vars = n;
+    res.n_constraints = cs.size();
+    collect_stats(res, s);
+    return res;
+}
+
+/**
+ * An incremental loop, as performed by a planner: at each round, a few tentative constraints are added and checked, and the inconsistent or unlucky ones are retracted.
+ */
+static scenario_result incremental_planning(std::mt19937 &rng, const std::size_t n, const std::size_t rounds)
+{
+    scenario_result res;
+    linspire::solver s;
+    std::vector<utils::var> xs;
+    std::uniform_int_distribution<int> coeff_dist(-2, 2), bound_dist(-20, 20);
+    std::uniform_int_distribution<std::size_t> var_dist(0, n - 1);
+    std::deque<linspire::constraint> cs;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        xs.push_back(s.new_var());
+        res.sat &= s.new_gt({{xs[i], 1}}, -100, false, cs.emplace_back());
+        res.sat &= s.new_lt({{xs[i], 1}}, 100, false, cs.emplace_back());
+    }
+    for (std::size_t r = 0; r < rounds; ++r)
+    {
+        std::vector<linspire::constraint *> tentative;
+        for (int t = 0; t < 4; ++t)
+        {
+            utils::lin l;
+            for (int v = 0; v < 3; ++v)
+                if (const auto c = coeff_dist(rng); c != 0)
+                    l.vars.emplace(xs[var_dist(rng)], c);
+            if (l.vars.empty())
+                continue;
+            auto &c = cs.emplace_back();
+            if (!s.new_lt(l, bound_dist(rng), false, c))
+                s.retract(c);
+            else
+            {
+                ++res.n_checks;
+                if (s.check())
+                    tentative.push_back(&c);
+                else
+                    s.retract(c);
+            }
+        }
+        // we keep one tentative constraint out of two..
+        for (std::size_t t = 0; t < tentative.size(); t += 2)
+            s.retract(*tentative[t]);
+        ++res.n_checks;
+        res.sat &= s.check();
+    }
+    res.n_vars = n;
+    res.n_constraints = cs.size();
+    collect_stats(res, s);
+    return res;
+}
+
+static json::json run(const std::function<scenario_result()> &scenario)
+{
+    const auto allocs = n_allocs.load();
+    const auto bytes = allocated_bytes.load();
+    const auto start = std::chrono::steady_clock::now();
+    const auto res = scenario();
+    const auto end = std::chrono::steady_clock::now();
+    json::json j;
+    j["vars"] = static_cast<long long>(res.n_vars);
+    j["constraints"] = static_cast<long long>(res.n_constraints);
+    j["checks"] = static_cast<long long>(res.n_checks);
+    j["sat"] = res.sat;
+    j["time_us"] = static_cast<long long>(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
+    j["allocations"] = static_cast<long long>(n_allocs.load() - allocs);
+    j["allocated_bytes"] = static_cast<long long>(allocated_bytes.load() - bytes);
+    j["memory"] = res.memory;
+#ifdef LINSPIRE_ENABLE_STATISTICS
+    j["stats"] = res.stats;
+#endif
+    return j;
+}
+
+int main(int argc, char **argv)
+{
+    // usage: linspire_bench [scale] [seed] [scenario]
+    const std::size_t scale = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1;
+    const unsigned seed = argc > 2 ? static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10)) : 0;
+
+    json::json j;
+    j["version"] = LINSPIRE_VERSION;
+    j["scale"] = static_cast<long long>(scale);
+    j["seed"] = static_cast<long long>(seed);
+    json::json j_scenarios;
+    std::mt19937 rng(seed);
+    const std::vector<std::pair<std::string, std::function<scenario_result()>>> scenarios = {
+        {"random_sparse_lp", [&]
+         { return random_sparse_lp(rng, 40 * scale, 50 * scale, 3); }},
+        {"scheduling_chains", [&]
+         { return scheduling_chains(rng, 10 * scale, 20); }},
+        {"dense_equalities", [&]
+         { return dense_equalities(rng, 12 * scale, 6 * scale); }},
+        {"incremental_planning", [&]
+         { return incremental_planning(rng, 50 * scale, 100 * scale); }}};
+    for (const auto &[name, scenario] : scenarios)
+        if (argc <= 3 || name == argv[3])
+            j_scenarios[name] = run(scenario);
+    j["scenarios"] = j_scenarios;
+#if defined(__unix__) || defined(__APPLE__)
+    if (rusage usage; getrusage(RUSAGE_SELF, &usage) == 0)
+#ifdef __APPLE__
+        j["max_rss_kb"] = static_cast<long long>(usage.ru_maxrss / 1024); // bytes on macOS..
+#else
+        j["max_rss_kb"] = static_cast<long long>(usage.ru_maxrss);
+#endif
+#endif
+    std::cout << j.dump() << std::endl;
+    return 0;
+}
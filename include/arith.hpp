@@ -0,0 +1,284 @@
+#pragma once
+
+#include "inf_rational.hpp"
+#include "lin.hpp"
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <type_traits>
+
+namespace linspire
+{
+  using integer_type = std::decay_t<decltype(std::declval<utils::rational>().numerator())>;
+
+  /**
+   * @brief Computes `a * b` on machine integers, checking for overflows.
+   *
+   * @param a The first factor.
+   * @param b The second factor.
+   * @param r The product, meaningful only if no overflow occurred.
+   * @return true if the product overflows, false otherwise.
+   */
+  [[nodiscard]] inline bool mul_overflow(const integer_type a, const integer_type b, integer_type &r) noexcept
+  {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_mul_overflow(a, b, &r);
+#else
+    constexpr auto max = std::numeric_limits<integer_type>::max();
+    constexpr auto min = std::numeric_limits<integer_type>::min();
+    if (a == 0 || b == 0)
+    {
+      r = 0;
+      return false;
+    }
+    if (a > 0 ? (b > 0 ? a > max / b : b < min / a) : (b > 0 ? a < min / b : a < max / b))
+      return true;
+    r = a * b;
+    return false;
+#endif
+  }
+  /**
+   * @brief Computes `a + b` on machine integers, checking for overflows.
+   *
+   * @param a The first addend.
+   * @param b The second addend.
+   * @param r The sum, meaningful only if no overflow occurred.
+   * @return true if the sum overflows, false otherwise.
+   */
+  [[nodiscard]] inline bool add_overflow(const integer_type a, const integer_type b, integer_type &r) noexcept
+  {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_add_overflow(a, b, &r);
+#else
+    if ((b > 0 && a > std::numeric_limits<integer_type>::max() - b) || (b < 0 && a < std::numeric_limits<integer_type>::min() - b))
+      return true;
+    r = a + b;
+    return false;
+#endif
+  }
+
+  /**
+   * @brief Whether an operation of the calling thread has overflowed the machine integers of the rationals.
+   *
+   * Rationals have no big-number representation, hence a numerator or a denominator which does not fit in an
+   * `integer_type` makes the result meaningless. The helpers below detect such overflows, and set this flag, so that
+   * `solver::check` can return `check_result::unknown` rather than a wrong answer. Each solver sets the flag aside for
+   * the duration of its operations, collecting their overflows into its own state, and restores it afterwards.
+   */
+  inline thread_local bool arith_overflow = false;
+
+  /**
+   * @brief Returns `a * b` by the general rational arithmetic, setting `arith_overflow` if the result does not fit.
+   */
+  [[nodiscard]] inline utils::rational checked_mul(const utils::rational &a, const utils::rational &b) noexcept
+  {
+    constexpr auto min = std::numeric_limits<integer_type>::min(); // neither negated nor passed to `std::gcd`..
+    if (is_infinite(a) || is_infinite(b))
+      return a * b;
+    if (a.numerator() == min || b.numerator() == min || a.denominator() == min || b.denominator() == min)
+    { // the latter are left by the previous overflows only..
+      arith_overflow = true;
+      return a * b;
+    }
+    // we cross-reduce the factors, so that only a product which does not fit in lowest terms is an overflow..
+    const auto g_a = std::gcd(a.numerator(), b.denominator()), g_b = std::gcd(b.numerator(), a.denominator());
+    if (integer_type n, d; !mul_overflow(a.numerator() / g_a, b.numerator() / g_b, n) && !mul_overflow(a.denominator() / g_b, b.denominator() / g_a, d))
+      return utils::rational(n, d);
+    arith_overflow = true;
+    return a * b;
+  }
+  /**
+   * @brief Returns `a + b` by the general rational arithmetic, setting `arith_overflow` if the result does not fit.
+   */
+  [[nodiscard]] inline utils::rational checked_add(const utils::rational &a, const utils::rational &b) noexcept
+  {
+    if (is_infinite(a) || is_infinite(b))
+      return a + b;
+    if (a.denominator() == std::numeric_limits<integer_type>::min() || b.denominator() == std::numeric_limits<integer_type>::min())
+    { // left by the previous overflows only, and not passed to `std::gcd`..
+      arith_overflow = true;
+      return a + b;
+    }
+    // `a + b` is `(n_a * (d_b / g) + n_b * (d_a / g)) / (d_a * (d_b / g))`..
+    const auto g = std::gcd(a.denominator(), b.denominator());
+    if (integer_type l, r, n, d; !mul_overflow(a.numerator(), b.denominator() / g, l) && !mul_overflow(b.numerator(), a.denominator() / g, r) && !add_overflow(l, r, n) && !mul_overflow(a.denominator(), b.denominator() / g, d))
+      return utils::rational(n, d);
+    arith_overflow = true;
+    return a + b;
+  }
+
+  /**
+   * @brief Returns `a * b`.
+   *
+   * When both factors are integers and the product fits in a machine integer, the product is computed without any
+   * normalization. Otherwise, the computation falls back to the general rational arithmetic, checking for overflows.
+   */
+  [[nodiscard]] inline utils::rational mul(const utils::rational &a, const utils::rational &b) noexcept
+  {
+    if (integer_type r; a.denominator() == 1 && b.denominator() == 1 && !mul_overflow(a.numerator(), b.numerator(), r))
+      return utils::rational(r);
+    return checked_mul(a, b);
+  }
+  /**
+   * @brief Returns `a + b * c`.
+   *
+   * When all the operands are integers and no intermediate result overflows, the computation is performed on machine
+   * integers. Otherwise, it falls back to the general rational arithmetic, checking for overflows.
+   */
+  [[nodiscard]] inline utils::rational add_mul(const utils::rational &a, const utils::rational &b, const utils::rational &c) noexcept
+  {
+    if (integer_type p, r; a.denominator() == 1 && b.denominator() == 1 && c.denominator() == 1 && !mul_overflow(b.numerator(), c.numerator(), p) && !add_overflow(a.numerator(), p, r))
+      return utils::rational(r);
+    return checked_add(a, checked_mul(b, c));
+  }
+  /**
+   * @brief Returns `-a`, setting `arith_overflow` if the result does not fit.
+   */
+  [[nodiscard]] inline utils::rational neg(const utils::rational &a) noexcept
+  {
+    if (a.numerator() != std::numeric_limits<integer_type>::min())
+      return -a;
+    arith_overflow = true;
+    return a; // the negation is meaningless anyway..
+  }
+  /**
+   * @brief Returns `a + b`.
+   *
+   * When both addends are integers and the sum fits in a machine integer, the sum is computed without any
+   * normalization. Otherwise, the computation falls back to the general rational arithmetic, checking for overflows.
+   */
+  [[nodiscard]] inline utils::rational add(const utils::rational &a, const utils::rational &b) noexcept
+  {
+    if (integer_type r; a.denominator() == 1 && b.denominator() == 1 && !add_overflow(a.numerator(), b.numerator(), r))
+      return utils::rational(r);
+    return checked_add(a, b);
+  }
+  /**
+   * @brief Returns `a - b`, checking for overflows as `add` does.
+   */
+  [[nodiscard]] inline utils::rational sub(const utils::rational &a, const utils::rational &b) noexcept { return add(a, neg(b)); }
+  /**
+   * @brief Returns `a / b`.
+   *
+   * Divisions by unit integers are performed as (possibly negated) copies, avoiding any normalization. Other
+   * divisions fall back to the general rational arithmetic, checking for overflows.
+   */
+  [[nodiscard]] inline utils::rational div(const utils::rational &a, const utils::rational &b) noexcept
+  {
+    if (b.denominator() == 1 && b.numerator() == 1)
+      return a;
+    if (b.denominator() == 1 && b.numerator() == -1 && a.numerator() != std::numeric_limits<integer_type>::min())
+      return -a;
+    if (is_infinite(a) || is_infinite(b) || is_zero(b))
+      return a / b;
+    if (b.numerator() == std::numeric_limits<integer_type>::min())
+    { // the reciprocal of `b` does not fit..
+      arith_overflow = true;
+      return a / b;
+    }
+    // `a / b` is `a` times the reciprocal of `b`, whose sign is moved to the numerator..
+    return checked_mul(a, is_negative(b) ? utils::rational(-b.denominator(), -b.numerator()) : utils::rational(b.denominator(), b.numerator()));
+  }
+  /**
+   * @brief Returns `a * b`, where `b` is an infinitesimal rational.
+   */
+  [[nodiscard]] inline utils::inf_rational mul(const utils::rational &a, const utils::inf_rational &b) noexcept
+  {
+    if (is_infinite(a) || is_infinite(b.get_rational()))
+      return b * a;
+    return utils::inf_rational(mul(a, b.get_rational()), mul(a, b.get_infinitesimal()));
+  }
+  /**
+   * @brief Adds `b * c` to `a`, where `a` and `c` are infinitesimal rationals.
+   */
+  inline void add_mul(utils::inf_rational &a, const utils::rational &b, const utils::inf_rational &c) noexcept
+  {
+    if (is_infinite(a.get_rational()) || is_infinite(b) || is_infinite(c.get_rational()))
+      a += c * b;
+    else
+      a = utils::inf_rational(add_mul(a.get_rational(), b, c.get_rational()), add_mul(a.get_infinitesimal(), b, c.get_infinitesimal()));
+  }
+  /**
+   * @brief Returns `-a`, where `a` is an infinitesimal rational.
+   */
+  [[nodiscard]] inline utils::inf_rational neg(const utils::inf_rational &a) noexcept
+  {
+    if (is_infinite(a.get_rational()))
+      return -a;
+    return utils::inf_rational(neg(a.get_rational()), neg(a.get_infinitesimal()));
+  }
+  /**
+   * @brief Returns `a + b`, where `a` and `b` are infinitesimal rationals.
+   */
+  [[nodiscard]] inline utils::inf_rational add(const utils::inf_rational &a, const utils::inf_rational &b) noexcept
+  {
+    if (is_infinite(a.get_rational()) || is_infinite(b.get_rational()))
+      return a + b;
+    return utils::inf_rational(add(a.get_rational(), b.get_rational()), add(a.get_infinitesimal(), b.get_infinitesimal()));
+  }
+  /**
+   * @brief Returns `a - b`, where `a` and `b` are infinitesimal rationals.
+   */
+  [[nodiscard]] inline utils::inf_rational sub(const utils::inf_rational &a, const utils::inf_rational &b) noexcept { return add(a, neg(b)); }
+  /**
+   * @brief Returns `a / b`, where `a` is an infinitesimal rational.
+   *
+   * Divisions by unit integers are performed as (possibly negated) copies, avoiding any normalization.
+   */
+  [[nodiscard]] inline utils::inf_rational div(const utils::inf_rational &a, const utils::rational &b) noexcept
+  {
+    if (b.denominator() == 1 && b.numerator() == 1)
+      return a;
+    if (is_infinite(a.get_rational()) || is_infinite(b))
+      return a / b;
+    return utils::inf_rational(div(a.get_rational(), b), div(a.get_infinitesimal(), b));
+  }
+
+  /**
+   * @brief Returns the linear expression `a - b`, dropping the terms which cancel out.
+   */
+  [[nodiscard]] inline utils::lin sub(const utils::lin &a, const utils::lin &b) noexcept
+  {
+    utils::lin r(sub(a.known_term, b.known_term));
+    r.vars = a.vars;
+    for (const auto &[v, c] : b.vars)
+      if (auto [it, inserted] = r.vars.emplace(v, neg(c)); !inserted)
+      {
+        it->second = sub(it->second, c);
+        if (is_zero(it->second))
+          r.vars.erase(it);
+      }
+    return r;
+  }
+
+  /**
+   * @brief Checks whether the coefficient `c` is zero.
+   */
+  [[nodiscard]] inline bool is_negligible(const utils::rational &c) noexcept { return c == 0; }
+
+  constexpr double float_eps = 1e-9; // the tolerance used by the floating-point arithmetic..
+
+  /**
+   * @brief Converts the rational `r` into the nearest floating-point number.
+   *
+   * Infinite rationals are converted into infinite floating-point numbers.
+   */
+  [[nodiscard]] inline double to_double(const utils::rational &r) noexcept
+  {
+    if (r == utils::rational::positive_infinite)
+      return std::numeric_limits<double>::infinity();
+    if (r == utils::rational::negative_infinite)
+      return -std::numeric_limits<double>::infinity();
+    return static_cast<double>(r.numerator()) / static_cast<double>(r.denominator());
+  }
+
+  // the floating-point counterparts of the exact arithmetic, used by the floating-point shadow of the tableau..
+  [[nodiscard]] inline double mul(const double a, const double b) noexcept { return a * b; }
+  [[nodiscard]] inline double add_mul(const double a, const double b, const double c) noexcept { return a + b * c; }
+  [[nodiscard]] inline double neg(const double a) noexcept { return -a; }
+  [[nodiscard]] inline double div(const double a, const double b) noexcept { return a / b; }
+  /**
+   * @brief Checks whether the floating-point coefficient `c` is zero, up to the `float_eps` tolerance.
+   */
+  [[nodiscard]] inline bool is_negligible(const double c) noexcept { return std::abs(c) <= float_eps; }
+} // namespace linspire
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+namespace linspire
+{
+  /**
+   * @brief A value shared, copy-on-write, among the solvers cloned from one another.
+   *
+   * Copying the wrapper just shares the value, through a reference count. The value is read through `*` and `->`,
+   * and written through `write()`, which first gives the writer a private copy if the value is still shared.
+   *
+   * @tparam T The type of the shared value.
+   */
+  template <typename T>
+  class cow
+  {
+  public:
+    cow() noexcept : ptr(std::make_shared<T>()) {}
+
+    [[nodiscard]] const T &operator*() const noexcept { return *ptr; }
+    [[nodiscard]] const T *operator->() const noexcept { return ptr.get(); }
+
+    /**
+     * @brief Returns the value for writing, copying it first if other solvers share it.
+     */
+    [[nodiscard]] T &write() noexcept
+    {
+      if (ptr.use_count() != 1)
+        ptr = std::make_shared<T>(*ptr);
+      else // the other owners might have just released the value, on other threads, after reading it..
+        std::atomic_thread_fence(std::memory_order_acquire);
+      return *ptr;
+    }
+    /**
+     * @brief Replaces the value with `v`, leaving any other owner with the previous one.
+     */
+    void assign(T &&v) noexcept { ptr = std::make_shared<T>(std::move(v)); }
+
+    /**
+     * @brief Checks whether the value is shared with other solvers.
+     */
+    [[nodiscard]] bool shared() const noexcept { return ptr.use_count() > 1; }
+
+  private:
+    std::shared_ptr<T> ptr;
+  };
+} // namespace linspire
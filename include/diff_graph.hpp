@@ -0,0 +1,113 @@
+#pragma once
+
+#include "inf_rational.hpp"
+#include <limits>
+#include <vector>
+
+namespace linspire
+{
+  /**
+   * @brief A graph of difference constraints, with an incremental detection of the negative cycles.
+   *
+   * Each constraint `v - u <= w` is an edge `u -> v` of weight `w`. The graph keeps a potential function `pi`, such
+   * that `pi(v) - pi(u) <= w` for all the active edges which are not queued, which is hence a solution of the
+   * corresponding constraints. Tightening an edge just queues it, while `check` restores the potential function through
+   * a Dijkstra visit of the reduced costs starting from each queued edge, detecting the negative cycles closed by the
+   * edge (Cotton and Maler, 2006). Since relaxing or removing an edge never breaks the potential function, both are free.
+   *
+   * Edges are identified by the caller, with dense identifiers, and are inactive (i.e., have an infinite weight) until
+   * a weight is set.
+   */
+  class difference_graph
+  {
+  public:
+    using vertex = std::size_t;
+    using edge = std::size_t;
+    static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+    /**
+     * @brief Adds the inactive edge `e`, from `from` to `to`.
+     */
+    void add_edge(const edge e, const vertex from, const vertex to) noexcept;
+    /**
+     * @brief Removes the edge `e`.
+     */
+    void remove_edge(const edge e) noexcept;
+    /**
+     * @brief Checks whether the edge `e` exists.
+     */
+    [[nodiscard]] bool has_edge(const edge e) const noexcept { return e < edges.size() && edges[e].from != npos; }
+
+    /**
+     * @brief Sets the weight of the edge `e`, queuing the edge if its weight decreases.
+     */
+    void set_weight(const edge e, const utils::inf_rational &w) noexcept;
+    /**
+     * @brief Makes the edge `e` inactive.
+     */
+    void unset_weight(const edge e) noexcept;
+
+    /**
+     * @brief Checks the queued edges, updating the potential function.
+     *
+     * On failure the potential function is left untouched, the edges which have not been checked remain queued, and
+     * the edges of the negative cycle are available through `get_cycle`.
+     *
+     * @return false if a negative cycle has been found, true otherwise.
+     */
+    [[nodiscard]] bool check() noexcept;
+    /**
+     * @brief Returns the edges of the negative cycle found by the last failed `check`.
+     */
+    [[nodiscard]] const std::vector<edge> &get_cycle() const noexcept { return cycle; }
+    /**
+     * @brief Returns the potential of the vertex `v`.
+     */
+    [[nodiscard]] utils::inf_rational potential(const vertex v) const noexcept { return v < pi.size() ? pi[v] : utils::inf_rational(utils::rational::zero); }
+
+    /**
+     * @brief Releases the unused capacity of the graph.
+     */
+    void compact() noexcept;
+    /**
+     * @brief Returns the number of bytes allocated by the graph, including the unused capacity of its arrays.
+     */
+    [[nodiscard]] std::size_t memory_usage() const noexcept;
+
+  private:
+    enum visit_state : unsigned char
+    {
+      unvisited, // the vertex has not been reached by the current visit..
+      reached,   // the potential of the vertex has to be lowered, by an amount which might still change..
+      settled    // the potential of the vertex has to be lowered by its final amount..
+    };
+
+    struct edge_data
+    {
+      vertex from = npos, to = npos; // the endpoints of the edge..
+      edge prev = npos, next = npos; // the neighbouring edges within the (intrusive) list of the outgoing edges of `from`..
+      utils::inf_rational w;         // the weight of the edge..
+      bool active = false;           // whether the edge has a (finite) weight..
+      bool queued = false;           // whether the edge is queued for being checked, hence possibly not satisfied by the potential function..
+    };
+
+    /**
+     * @brief Checks the edge `e`, updating the potential function.
+     *
+     * @return false if the edge closes a negative cycle, true otherwise.
+     */
+    [[nodiscard]] bool check(const edge e) noexcept;
+
+  private:
+    std::vector<edge_data> edges;              // the edges, indexed by their identifiers..
+    std::vector<edge> first_out;               // for each vertex, the first of its outgoing edges..
+    std::vector<utils::inf_rational> pi;       // the potential function..
+    std::vector<edge> queue;                   // the edges to be checked..
+    std::vector<edge> cycle;                   // the edges of the last negative cycle..
+    std::vector<utils::inf_rational> gamma;    // for each vertex, the (negative) change of its potential during a visit..
+    std::vector<edge> pred;                    // for each vertex, the edge through which its change has been found..
+    std::vector<visit_state> state;            // for each vertex, its state within the current visit..
+    std::vector<vertex> visited;               // the vertices reached by the current visit..
+    std::vector<std::pair<utils::inf_rational, vertex>> heap; // the reached vertices, ordered by their change..
+  };
+} // namespace linspire
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "lin.hpp"
+#include <optional>
+#include <vector>
+
+namespace linspire
+{
+  /**
+   * @brief An open-addressing hash table associating linear expressions with the slack variables defining them.
+   *
+   * Expressions are hashed and compared structurally, on their (variable, coefficient) terms and on their known term,
+   * so that no intermediate representation has to be built for looking them up. Collisions are resolved by linear
+   * probing and removed entries are marked as deleted, so that probe sequences are not broken.
+   */
+  class expr_table
+  {
+  public:
+    /**
+     * @brief Returns the slack variable associated with the linear expression `l`.
+     *
+     * @param l The linear expression to look up.
+     * @return The slack variable associated with `l`, or an empty optional if `l` is not in the table.
+     */
+    [[nodiscard]] std::optional<utils::var> find(const utils::lin &l) const noexcept;
+    /**
+     * @brief Associates the linear expression `l` with the slack variable `x`.
+     *
+     * @param l The linear expression, which must not be already in the table.
+     * @param x The slack variable defining `l`.
+     */
+    void insert(const utils::lin &l, const utils::var x) noexcept;
+    /**
+     * @brief Removes the linear expression `l` from the table.
+     *
+     * @param l The linear expression to remove.
+     * @return true if `l` was in the table, false otherwise.
+     */
+    bool erase(const utils::lin &l) noexcept;
+
+    /**
+     * @brief Returns the number of expressions in the table.
+     */
+    [[nodiscard]] std::size_t size() const noexcept { return n_full; }
+    /**
+     * @brief Returns the number of bytes allocated by the slots and by the terms of the stored expressions.
+     */
+    [[nodiscard]] std::size_t memory_usage() const noexcept;
+    /**
+     * @brief Calls `f` on each expression of the table, given as its terms (sorted by variable) and its known term, together with its slack variable.
+     */
+    template <typename F>
+    void for_each(F &&f) const
+    {
+      for (const auto &s : slots)
+        if (s.state == slot_state::full)
+          f(s.terms, s.known_term, s.slack);
+    }
+
+  private:
+    enum class slot_state : unsigned char
+    {
+      empty,   // the slot has never been used..
+      full,    // the slot contains an expression..
+      deleted, // the slot contained an expression which has been removed..
+    };
+
+    struct slot
+    {
+      slot_state state = slot_state::empty;
+      std::size_t hash = 0;                                     // the hash of the expression..
+      utils::var slack = 0;                                     // the slack variable defining the expression..
+      std::vector<std::pair<utils::var, utils::rational>> terms; // the terms of the expression, sorted by variable..
+      utils::rational known_term;                               // the known term of the expression..
+    };
+
+    [[nodiscard]] static std::size_t hash(const utils::lin &l) noexcept;
+    [[nodiscard]] static bool equals(const slot &s, const std::size_t h, const utils::lin &l) noexcept;
+    /**
+     * @brief Returns the position of the slot containing the linear expression `l`, or `slots.size()` if `l` is not in the table.
+     */
+    [[nodiscard]] std::size_t position(const utils::lin &l, const std::size_t h) const noexcept;
+    void rehash(const std::size_t n_slots) noexcept;
+
+  private:
+    std::vector<slot> slots;   // the slots of the table, whose number is always a power of two..
+    std::size_t n_full = 0;    // the number of full slots..
+    std::size_t n_deleted = 0; // the number of deleted slots..
+  };
+} // namespace linspire
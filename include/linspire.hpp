@@ -1,7 +1,26 @@
 #pragma once
 
+#include "arith.hpp"
 #include "var.hpp"
+#include "tableau.hpp"
+#include "cow.hpp"
+#include "expr_table.hpp"
+#include "diff_graph.hpp"
+#include "snapshot.hpp"
+#include <atomic>
+#include <chrono>
+#include <istream>
+#include <limits>
+#include <map>
+#include <ostream>
+#include <tuple>
 #include <unordered_map>
+#ifdef LINSPIRE_ENABLE_LISTENERS
+#include <algorithm>
+#endif
+#ifdef LINSPIRE_ENABLE_TRACE
+#include "trace.hpp"
+#endif
 
 namespace linspire
 {
@@ -9,6 +28,114 @@ namespace linspire
   class listener;
 #endif
 
+  /**
+   * @brief The rules for selecting the leaving (basic) variable during the `check` procedure.
+   */
+  enum class leaving_rule
+  {
+    bland,              // the smallest violated basic variable..
+    max_violation,      // the basic variable whose value is the farthest from its bounds..
+    least_infeasibility // the basic variable whose value is the closest to its bounds..
+  };
+
+  /**
+   * @brief The rules for selecting the entering (non-basic) variable during the `check` procedure.
+   */
+  enum class entering_rule
+  {
+    bland,           // the smallest suitable non-basic variable..
+    min_occurrences, // the suitable non-basic variable appearing in the fewest tableau rows..
+    greatest_slack,  // the suitable non-basic variable which can move the farthest before reaching its bounds..
+    steepest_edge    // the suitable non-basic variable with the largest coefficient relative to the (approximated) norm of its column..
+  };
+
+  /**
+   * @brief The pivot selection strategy used by the `check` procedure.
+   *
+   * Whatever the chosen rules, the solver falls back to Bland's rule after `bland_threshold` degenerate pivots
+   * (i.e., pivots that do not reduce the number of violated basic variables) within a single `check` call, so
+   * that termination is guaranteed.
+   */
+  struct pivot_rule
+  {
+    leaving_rule leaving = leaving_rule::bland;    // the rule for selecting the leaving variable..
+    entering_rule entering = entering_rule::bland; // the rule for selecting the entering variable..
+    std::size_t bland_threshold = 100;             // the number of degenerate pivots after which Bland's rule is used..
+  };
+
+  /**
+   * @brief The outcome of a `check` call with a budget.
+   */
+  enum class check_result
+  {
+    sat,    // the constraints are consistent, and the current assignment satisfies them..
+    unsat,  // the constraints are inconsistent, and a conflict explanation is available..
+    unknown // the budget has been exhausted, or the rational arithmetic has overflowed, before reaching a conclusion..
+  };
+
+  /**
+   * @brief The limits on the work performed by a single `check` call.
+   */
+  struct check_budget
+  {
+    std::size_t max_pivots = std::numeric_limits<std::size_t>::max(); // the maximum number of pivots..
+    std::optional<std::chrono::steady_clock::time_point> deadline;    // the time after which no more pivots are performed, if any..
+    const std::atomic<bool> *cancel = nullptr;                        // the flag which, once set by any thread, stops the procedure, if any..
+  };
+
+#ifdef LINSPIRE_ENABLE_STATISTICS
+  /**
+   * @brief The statistics collected by the solver.
+   */
+  struct statistics
+  {
+    std::size_t n_checks = 0;              // the number of `check` calls..
+    std::size_t n_pivots = 0;              // the number of pivots..
+    std::size_t n_updates = 0;             // the number of `update` calls..
+    std::size_t n_touched_rows = 0;        // the number of rows rewritten by the pivots, other than the pivot rows..
+    std::size_t n_conflicts = 0;           // the number of conflicts..
+    std::size_t n_reused_slacks = 0;       // the number of slack variables reused for already existing expressions..
+    std::size_t max_row_length = 0;        // the length of the longest tableau row..
+    double avg_row_length = 0;             // the average length of the tableau rows..
+    std::chrono::nanoseconds check_time{}; // the cumulative time spent in `check`..
+    std::chrono::nanoseconds pivot_time{}; // the cumulative time spent in pivoting..
+  };
+#endif
+
+  /**
+   * @brief A bound implied by the tableau rows, as derived by the `propagate` procedure.
+   */
+  struct implied_bound
+  {
+    utils::var x;                                                  // the bounded variable..
+    bool upper;                                                    // whether the bound is an upper bound..
+    utils::inf_rational value;                                     // the value of the bound..
+    std::vector<std::reference_wrapper<const constraint>> reasons; // the constraints implying the bound..
+  };
+
+  /**
+   * @brief The memory footprint of a solver, in bytes, broken down by subsystem.
+   *
+   * The arrays are accounted with their unused capacity, while the nodes of the node-based containers are estimated
+   * from the size of their elements plus the pointers linking them. The bounds stored in the constraints, which are
+   * owned by the caller, and the chunks of the snapshots, which are shared with them, are not accounted.
+   */
+  struct memory_report
+  {
+    std::size_t vars = 0;                 // the variables, with their bound stacks, and the slack states..
+    std::size_t tableau = 0;              // the rows and the columns of the tableau, with the cached implied bounds..
+    std::size_t exprs = 0;                // the expressions of the slack variables, including the rows of the inactive ones..
+    std::size_t trail = 0;                // the undo trail and the backtracking points..
+    std::size_t conflicts = 0;            // the conflict explanation and the bounds derived by the propagation..
+    std::size_t differences = 0;          // the difference graph and the roles of the variables within it..
+    std::size_t listeners = 0;            // the listeners of the variables..
+    std::size_t other = 0;                // the violated variables, the pending batch, the snapshot table and the trace..
+    std::size_t shared = 0;               // the tableau and the expressions, when shared with clones, in place of their own entries..
+    std::vector<std::size_t> row_density; // the number of tableau rows by length, the `i`-th entry counting the rows with `[2^i, 2^(i+1))` terms (the first one also counting the empty rows)..
+
+    [[nodiscard]] std::size_t total() const noexcept { return vars + tableau + exprs + trail + conflicts + differences + listeners + other + shared; }
+  };
+
   class solver
   {
     friend class constraint;
@@ -33,7 +160,8 @@ namespace linspire
      * @brief Creates a new variable defined by a linear expression.
      *
      * This function constructs a new variable that is defined by a given linear expression.
-     * The linear expression specifies the relationship between the new variable and other variables.
+     * The linear expression specifies the relationship between the new variable and other variables. A variable created
+     * after a `push` is removed by the matching `pop`, unless its expression was already known before the `push`.
      *
      * @param l The linear expression defining the new variable.
      * @return A new instance of utils::var representing the variable.
@@ -80,7 +208,7 @@ namespace linspire
     {
       utils::inf_rational b(l.known_term);
       for (const auto &[v, c] : l.vars)
-        b += (is_positive(c) ? lb(v) * c : ub(v) * c);
+        add_mul(b, c, is_positive(c) ? lb(v) : ub(v));
       return b;
     }
     /**
@@ -96,7 +224,7 @@ namespace linspire
     {
       utils::inf_rational b(l.known_term);
       for (const auto &[v, c] : l.vars)
-        b += (is_positive(c) ? ub(v) * c : lb(v) * c);
+        add_mul(b, c, is_positive(c) ? ub(v) : lb(v));
       return b;
     }
     /**
@@ -112,7 +240,7 @@ namespace linspire
     {
       utils::inf_rational b(l.known_term);
       for (const auto &[v, c] : l.vars)
-        b += val(v) * c;
+        add_mul(b, c, val(v));
       return b;
     }
 
@@ -172,12 +300,57 @@ namespace linspire
      * @brief Retracts a previously added constraint from the solver.
      *
      * This function removes a previously added constraint from the solver. It updates the
-     * internal state of the solver to reflect the removal of the constraint.
+     * internal state of the solver to reflect the removal of the constraint. The slack variables
+     * left without bounds are deactivated, unless there are backtracking points.
+     *
+     * @see gc
      *
      * @param c The constraint to be retracted.
      */
     void retract(const constraint &c) noexcept;
 
+    /**
+     * @brief Starts a batch of constraint additions.
+     *
+     * Until the batch is committed, the values of the non-basic variables are not moved within their new bounds, so
+     * that adding many constraints does not repeatedly propagate values through the tableau. Bounds, rows and
+     * conflicts between bounds are handled as usual, but the values returned by `val` might be outdated.
+     */
+    void begin_batch() noexcept;
+    /**
+     * @brief Commits the current batch of constraint additions, if any.
+     *
+     * The non-basic variables whose bounds changed during the batch are moved within their bounds and the values of
+     * the basic variables are recomputed once. The `check` procedure commits the current batch implicitly.
+     */
+    void commit() noexcept;
+
+    /**
+     * @brief Creates a new backtracking point.
+     *
+     * The bound changes, the tableau rows and the slack variables created after this call are recorded on an undo
+     * trail, so that they can be undone by a subsequent call to `pop`.
+     */
+    void push() noexcept;
+    /**
+     * @brief Backtracks to the `n`-th most recent backtracking point.
+     *
+     * The changes recorded since the corresponding `push` are undone in reverse chronological order, at a cost which
+     * is proportional to their number. The current assignment is kept since, as bounds can only be relaxed, it stays
+     * valid for the non-basic variables. Bounds removed in the meanwhile through `retract` are not restored.
+     *
+     * The slack variables created since the `push` are removed, including the ones returned by `new_var(utils::lin &&)`
+     * for an expression first introduced since then: their identifiers become invalid, and are reused by the next
+     * variables. A slack variable with listeners is rather kept as a plain variable, which `release` can reclaim.
+     *
+     * @param n The number of backtracking points to pop (default: 1).
+     */
+    void pop(const std::size_t n = 1) noexcept;
+    /**
+     * @brief Returns the number of backtracking points.
+     */
+    [[nodiscard]] std::size_t get_level() const noexcept { return levels.size(); }
+
     /**
      * @brief Checks the consistency of the current set of constraints.
      *
@@ -186,20 +359,357 @@ namespace linspire
      * is found, the function returns true; otherwise, it returns false, indicating that the
      * constraints are inconsistent.
      *
+     * The basic variables whose value violates their bounds are tracked incrementally as values
+     * and bounds change, so that the function returns immediately when all of them are satisfied.
+     *
+     * Rationals are kept on machine integers, with no big-number representation: when a computation of this solver
+     * overflows them since the previous check, the outcome is meaningless, hence the function returns false with an
+     * empty conflict explanation, and `overflowed()` tells this case apart from an inconsistency.
+     *
      * @return true if the constraints are consistent and a solution is found; false otherwise.
      */
     [[nodiscard]] bool check() noexcept;
+    /**
+     * @brief Checks the consistency of the current set of constraints, within the limits of `budget`.
+     *
+     * The limits are checked before each pivot, hence the procedure returns `check_result::unknown` as soon as the
+     * pivots, the time or the cancellation flag run out, leaving the solver with the basis and the assignment reached
+     * so far. The next call, with or without budget, continues from there, keeping the count of degenerate pivots so
+     * that the fallback to Bland's rule still guarantees termination, and skipping the pre-solve stages, which have
+     * already been performed and are not subject to the budget. The procedure also returns `check_result::unknown`
+     * when the rational arithmetic of this solver has overflowed since the previous check, either within this call or
+     * while adding, retracting or backtracking constraints. The overflows are reported once, by the check which follows them.
+     *
+     * @param budget The limits on the work performed by this call.
+     * @return The outcome of the check.
+     */
+    [[nodiscard]] check_result check(const check_budget &budget) noexcept;
+    /**
+     * @brief Checks the consistency of the current set of constraints by a portfolio of pivot rules run in parallel.
+     *
+     * This solver runs the `check` procedure with the first rule, while clones of it run the procedure with the other
+     * rules, each on its own thread. The first one reaching a conclusion stops the others. If a clone finds a
+     * solution, its basis and assignment are imported through `warm_start`; if it finds an inconsistency, its
+     * conflict explanation is mapped back to the constraints of `cs`. When the state cannot be cloned (e.g., during
+     * a batch, or if a bound has a reason which is not in `cs`), or fewer than two rules are given, the procedure
+     * runs on this solver alone, with the first rule, if any. Clones whose thread cannot be created stay out of the race.
+     * As for `check`, false is returned, and `overflowed()` is set, if the rational arithmetic overflows in all of them.
+     *
+     * @param rules The pivot selection strategies of the portfolio, one per thread.
+     * @param cs The constraints which might be the reason of a bound.
+     * @return true if the constraints are consistent and a solution is found; false otherwise.
+     */
+    [[nodiscard]] bool check(const std::vector<pivot_rule> &rules, const std::vector<std::reference_wrapper<const constraint>> &cs) noexcept;
+    /**
+     * @brief Checks whether the last check, or optimization, has been stopped by an overflow of the rational arithmetic.
+     *
+     * In that case, neither the consistency nor the inconsistency of the constraints has been proven.
+     */
+    [[nodiscard]] bool overflowed() const noexcept { return c_overflowed; }
+
+    /**
+     * @brief Minimizes the linear expression `l` over the current set of constraints.
+     *
+     * Once `check` has found a feasible assignment, a primal simplex moves it, through the pivots of the tableau,
+     * towards the minimum of `l`, keeping all the variables within their bounds. The solver is left with the optimal
+     * assignment, and the constraints can be further modified and checked as usual. After a number of degenerate
+     * iterations, the pivots follow Bland's rule so as to guarantee termination.
+     *
+     * @param l The linear expression to minimize.
+     * @return The minimum of `l`, negative infinity if `l` is unbounded from below, or nothing if the constraints are inconsistent, in which case a conflict explanation is available, or if the rational arithmetic overflows, in which case `overflowed()` is set.
+     */
+    [[nodiscard]] std::optional<utils::inf_rational> minimize(const utils::lin &l) noexcept;
+    /**
+     * @brief Maximizes the linear expression `l` over the current set of constraints.
+     *
+     * @param l The linear expression to maximize.
+     * @return The maximum of `l`, positive infinity if `l` is unbounded from above, or nothing if the constraints are inconsistent, in which case a conflict explanation is available, or if the rational arithmetic overflows, in which case `overflowed()` is set.
+     * @see minimize
+     */
+    [[nodiscard]] std::optional<utils::inf_rational> maximize(const utils::lin &l) noexcept;
+
+    /**
+     * @brief Derives the bounds implied by the tableau rows, without pivoting.
+     *
+     * Each row `x_i = sum_j a_ij * x_j` bounds any of its variables through the bounds of the others. The derived
+     * bounds are chained, revisiting the rows of the variables whose bounds get tighter, until no row can tighten
+     * any bound or `budget` row visits have been performed. Each bound of each variable is derived at most once, so
+     * that cyclic dependencies do not trigger endless sequences of ever tighter bounds. The bounds which are tighter than the ones set on the
+     * variables are then available through `get_implied_bounds`, the listeners of their variables being notified.
+     *
+     * The derived bounds are not added to the solver, so that they do not survive the retraction of their reasons.
+     *
+     * @param budget The maximum number of row visits.
+     * @return false if the derived bounds are inconsistent, in which case a conflict explanation is available, true otherwise.
+     */
+    [[nodiscard]] bool propagate(const std::size_t budget) noexcept;
+    /**
+     * @brief Retrieves the bounds derived by the last `propagate` call, each with its reasons.
+     *
+     * @return A constant reference to the vector of the implied bounds.
+     */
+    [[nodiscard]] const std::vector<implied_bound> &get_implied_bounds() const noexcept { return i_bounds; }
+
+    /**
+     * @brief Returns the pivot selection strategy used by the `check` procedure.
+     *
+     * @return A constant reference to the current pivot rule.
+     */
+    [[nodiscard]] const pivot_rule &get_pivot_rule() const noexcept { return p_rule; }
+    /**
+     * @brief Sets the pivot selection strategy used by the `check` procedure.
+     *
+     * @param rule The new pivot rule.
+     */
+    void set_pivot_rule(const pivot_rule &rule) noexcept { p_rule = rule; }
+
+    /**
+     * @brief Checks whether the `check` procedure starts with a floating-point pre-solve.
+     *
+     * @return true if the floating-point pre-solve is enabled, false otherwise.
+     */
+    [[nodiscard]] bool get_float_presolve() const noexcept { return f_presolve; }
+    /**
+     * @brief Enables or disables the floating-point pre-solve of the `check` procedure.
+     *
+     * When enabled, the `check` procedure first repairs the bound violations on a `double` shadow of the tableau.
+     * The basis found this way is then replayed in exact arithmetic, and the usual exact procedure takes over from
+     * it, so that rounding errors can only cost additional pivots, never wrong answers.
+     *
+     * @param enable Whether the floating-point pre-solve should be enabled.
+     */
+    void set_float_presolve(const bool enable) noexcept { f_presolve = enable; }
+
+    /**
+     * @brief Checks whether the `check` procedure starts by eliminating the fixed basic variables.
+     *
+     * @return true if the elimination is enabled, false otherwise.
+     */
+    [[nodiscard]] bool get_fixed_elimination() const noexcept { return e_fixed; }
+    /**
+     * @brief Enables or disables the elimination of the fixed basic variables at the start of the `check` procedure.
+     *
+     * When enabled, each basic variable whose lower and upper bounds coincide, as the slack of an equality, is pivoted
+     * out of the basis against a non-fixed variable of its row, chosen among the ones appearing in the fewest rows. The
+     * equality thus eliminates that variable, while the fixed variable, being non-basic at its value, no longer needs
+     * repairing and never enters the basis again. Variables are not renumbered, hence values, bounds and conflict
+     * explanations keep referring to the original variables. The rows keep their size, though: the fixed non-basic
+     * variables are not substituted out of them, and no row is removed, since the rows have no constant term to
+     * absorb them and a later retraction might unfix any variable.
+     *
+     * @param enable Whether the elimination should be enabled.
+     */
+    void set_fixed_elimination(const bool enable) noexcept { e_fixed = enable; }
+
+    /**
+     * @brief Releases the memory that the solver retains for reuse.
+     *
+     * The unused capacity of the tableau, of the undo trail and of the internal buffers is released. Calling this
+     * function never changes the state of the solver. The nodes of the bound maps and of the variable sets are cached
+     * by block pools which are shared by all the solvers, and constraints, of a thread, hence they are left to
+     * `block_pool::release_all`, which returns the ones of the calling thread to the system.
+     */
+    void compact() noexcept;
+    /**
+     * @brief Returns the memory footprint of the solver, broken down by subsystem, together with the distribution of the lengths of the tableau rows.
+     */
+    [[nodiscard]] memory_report memory_usage() const noexcept;
+    /**
+     * @brief Reclaims the slack variables which no longer take part in any constraint.
+     *
+     * Retracting the last bound of a slack variable created by a constraint removes its row from the tableau at once,
+     * so that it is no longer scanned nor updated, while its row is kept aside, so that a new constraint on the same
+     * expression, or a constraint re-added through `add_constraint`, reactivates it. This function deactivates the
+     * unbounded slack variables whose retraction happened while there were backtracking points, then forgets the
+     * inactive ones, along with the variables released through `release`, whose identifiers are reused by the next
+     * variables to be created, or dropped by `renumber`. Variables which are listened to or appear in the expression
+     * of another slack variable are kept.
+     *
+     * @return The number of reclaimed variables, zero if there are backtracking points or a batch is in progress.
+     */
+    std::size_t gc() noexcept;
+    /**
+     * @brief Releases the variable `x`, which is no longer used by the caller.
+     *
+     * A basic variable is first pivoted out of the basis, while a variable created through `new_var(utils::lin &&)`
+     * loses its row. The variable is then fixed at its current value, so that the expressions still mentioning it
+     * keep their meaning, until `gc` reclaims its identifier once no expression mentions it anymore. The variable
+     * must not be used afterwards.
+     *
+     * @param x The variable to release.
+     * @return true if the variable has been released, false if there are backtracking points, a batch is in progress, `x` is a slack variable created by a constraint, is listened to or is still bounded by a constraint.
+     */
+    [[nodiscard]] bool release(const utils::var x) noexcept;
+    /**
+     * @brief Renumbers the variables so that their identifiers are dense again, dropping the ones reclaimed by `gc`.
+     *
+     * The live variables keep their relative order. The tableau, the expressions, the difference graph, the listeners
+     * and the bounds stored in the constraints of `cs` are rewritten on the new identifiers, and the per-variable
+     * arrays shrink accordingly. The snapshots taken before keep referring to the old identifiers.
+     *
+     * @param cs The constraints which might be the reason of a bound, whose stored bounds are renumbered as well.
+     * @return The table mapping each old identifier to the new one (`npos` for the reclaimed identifiers), or an empty optional if there are backtracking points, a batch is in progress or the reason of a bound is not in `cs`.
+     */
+    [[nodiscard]] std::optional<std::vector<utils::var>> renumber(const std::vector<std::reference_wrapper<constraint>> &cs) noexcept;
+
+    static constexpr utils::var npos = std::numeric_limits<utils::var>::max(); // the identifier of no variable..
+
+    /**
+     * @brief Writes the state of the solver in a compact binary form.
+     *
+     * The variables, with their values and bounds, the tableau, the expressions of the slack variables, the bounds
+     * stored in the constraints, with their scales, the rows of the inactive slack variables and the reusable identifiers are written as
+     * a flat sequence of 64-bit words in the native byte order, starting with a magic word and a format version, so
+     * that the output can be mapped in memory and checked before being loaded. Being constraints owned by the caller,
+     * they are identified by their position within `cs`. Options, listeners and trace are not part of the state.
+     *
+     * @param os The (binary) output stream.
+     * @param cs The constraints which might be the reason of a bound.
+     * @return true if the state has been written, false if there are backtracking points, a batch is in progress or the reason of a bound is not in `cs`.
+     */
+    [[nodiscard]] bool save(std::ostream &os, const std::vector<std::reference_wrapper<const constraint>> &cs) const noexcept;
+    /**
+     * @brief Restores the state written by `save` into this solver, which must have no variables.
+     *
+     * Since the saved assignment and basis are restored as they are, a solver saved right after a successful `check`
+     * needs no pivots to be checked again.
+     *
+     * @param is The (binary) input stream.
+     * @param cs The constraints corresponding, position by position, to the ones given to `save`, whose bounds are restored as well.
+     * @return true if the state has been restored, false if the input is not valid, in which case the solver is left untouched.
+     */
+    [[nodiscard]] bool load(std::istream &is, const std::vector<std::reference_wrapper<constraint>> &cs) noexcept;
+    /**
+     * @brief Copies the state of this solver into `dst`, which must have no variables.
+     *
+     * The clone gets its own assignment and bounds, and no backtracking points, while the reasons of its bounds are the
+     * constraints of `dst_cs`, which receive the bounds stored in the corresponding constraints of `cs`. Options are
+     * copied as well, while listeners, statistics and trace are not. The tableau and the expressions of the slack
+     * variables are shared, copy-on-write, hence forking a large solver costs no copy of them until either solver
+     * pivots, or adds or removes a row.
+     *
+     * @param dst The solver receiving the state.
+     * @param cs The constraints which might be the reason of a bound.
+     * @param dst_cs The constraints of the clone, corresponding position by position to `cs`.
+     * @return true if the state has been copied, false if a batch is in progress, the reason of a bound is not in `cs` or `dst` is not empty.
+     */
+    [[nodiscard]] bool clone(solver &dst, const std::vector<std::reference_wrapper<const constraint>> &cs, const std::vector<std::reference_wrapper<constraint>> &dst_cs) const noexcept;
+    /**
+     * @brief Moves the basis and the assignment of this solver towards the ones of `other`, as a warm start for the next `check`.
+     *
+     * The variables are matched by identifier. Each variable which is basic in `other` enters the basis, whenever a
+     * row of this solver contains it and has a basic variable which is non-basic in `other`, then the non-basic
+     * variables take the values they have in `other`, within their own bounds. Consistency is not affected, since
+     * only the starting point of the search changes.
+     *
+     * @param other The solver, typically a clone sharing the variables of this one, whose basis and assignment are imported.
+     */
+    void warm_start(const solver &other) noexcept;
+
+    /**
+     * @brief Returns an immutable view of the current values and bounds of the variables.
+     *
+     * The snapshot can be queried by any number of threads while this solver keeps being modified, yet, as any other
+     * member function, this one must be called by the thread modifying the solver. The variables are grouped in chunks
+     * which are shared with the previous snapshots, and only the chunks containing variables whose value or bounds
+     * have changed are copied, hence taking a snapshot of a solver which changed little is cheap. The bounds are the
+     * ones returned by `lb` and `ub`, including the bounds implied by the tableau rows.
+     *
+     * @return The snapshot of the solver.
+     */
+    [[nodiscard]] solver_snapshot snapshot() const noexcept;
+
+#ifdef LINSPIRE_ENABLE_STATISTICS
+    /**
+     * @brief Returns the statistics collected so far.
+     *
+     * Row lengths are computed on the current tableau, the other counters are cumulative.
+     *
+     * @return The statistics of the solver.
+     */
+    [[nodiscard]] statistics stats() const noexcept;
+#endif
+
+#ifdef LINSPIRE_ENABLE_TRACE
+    /**
+     * @brief Returns the buffer of the most recent pivots, bound changes, updates and conflicts.
+     *
+     * @return The trace buffer of the solver.
+     */
+    [[nodiscard]] const trace_buffer &get_trace() const noexcept { return c_trace; }
+    /**
+     * @brief Returns the buffer of the most recent pivots, bound changes, updates and conflicts, e.g., for resizing or clearing it.
+     *
+     * @return The trace buffer of the solver.
+     */
+    [[nodiscard]] trace_buffer &get_trace() noexcept { return c_trace; }
+#endif
 
     /**
      * @brief Retrieves the last conflict explanation.
      *
      * This function returns a reference to the vector containing the last conflict explanation.
      * The conflict explanation consists of a set of constraints that led to an inconsistency
-     * in the solver.
+     * in the solver. Every constraint appears at most once.
      *
      * @return A constant reference to the vector of constraints representing the last conflict explanation.
      */
     [[nodiscard]] const std::vector<std::reference_wrapper<const constraint>> &get_conflict() const noexcept { return cnfl; }
+    /**
+     * @brief Retrieves the Farkas multipliers of the last conflict explanation.
+     *
+     * The `i`-th multiplier `m_i` refers to the `i`-th constraint of `get_conflict`, and is positive if the upper bound
+     * imposed by the constraint is used, negative if its lower bound is. Each constraint bounds an expression `e_i`, as
+     * written (i.e., `lhs - rhs` for `new_lt` and `new_eq`, `rhs - lhs` for `new_gt`, divided by the coefficient when a
+     * single variable is left, whatever the rows the solver has rewritten it through), by the value `b_i`. The combination `sum_i m_i * e_i` is identically
+     * zero, while `sum_i m_i * b_i` is negative, accounting for the infinitesimals of strict bounds, hence the
+     * inconsistency. Constraints which are the reason of bounds on different expressions get the sum of the multipliers.
+     *
+     * @return A constant reference to the vector of multipliers of the last conflict explanation.
+     */
+    [[nodiscard]] const std::vector<utils::rational> &get_conflict_coefficients() const noexcept { return cnfl_coeffs; }
+
+    /**
+     * @brief Checks whether conflict explanations are minimized.
+     *
+     * @return true if conflict explanations are minimized, false otherwise.
+     */
+    [[nodiscard]] bool get_conflict_minimization() const noexcept { return c_minimize; }
+    /**
+     * @brief Enables or disables the minimization of conflict explanations.
+     *
+     * When enabled, each conflict explanation is shrunk by a deletion-based pass: the constraints are tentatively
+     * removed, starting from the ones with the smallest multipliers, and left out whenever the remaining ones are still
+     * inconsistent. The tests are performed on a scratch solver, hence without affecting the state of this one, and
+     * the resulting explanation is irreducible.
+     *
+     * @param enable Whether the conflict explanations should be minimized.
+     */
+    void set_conflict_minimization(const bool enable) noexcept { c_minimize = enable; }
+
+#ifdef LINSPIRE_ENABLE_LISTENERS
+    /**
+     * @brief Checks whether the value change notifications are deferred.
+     *
+     * @return true if the notifications are deferred, false otherwise.
+     */
+    [[nodiscard]] bool get_deferred_notifications() const noexcept { return deferred; }
+    /**
+     * @brief Enables or disables the deferral of the value change notifications.
+     *
+     * When enabled, the variables whose value changes are just marked, and each listener receives a single
+     * `on_values_changed` call with the changed variables it listens to at the end of the `check` procedure, no
+     * matter how many times their values have changed. Changes made outside the `check` procedure are delivered at
+     * the end of the next one, or by `flush_notifications`. Disabling the deferral delivers the pending notifications.
+     *
+     * @param enable Whether the notifications should be deferred.
+     */
+    void set_deferred_notifications(const bool enable) noexcept;
+    /**
+     * @brief Delivers the deferred value change notifications.
+     */
+    void flush_notifications() noexcept;
+#endif
 
     /**
      * @brief Checks if two linear expressions can be made equal.
@@ -213,14 +723,67 @@ namespace linspire
      */
     [[nodiscard]] bool match(const utils::lin &l0, const utils::lin &l1) const noexcept;
 
+    /**
+     * @brief Returns the lower and upper bounds of many linear expressions at once.
+     *
+     * The bounds of the variables occurring in the expressions are gathered once into dense arrays, resolving the
+     * bounds implied by the rows of the basic variables only for the first occurrence, and the expressions are then
+     * evaluated by a sweep over these arrays, split among `n_threads` threads when there are enough of them.
+     *
+     * @param ls The linear expressions whose bounds are to be computed.
+     * @param n_threads The number of threads evaluating the expressions (default: 1).
+     * @return The lower and upper bounds of each expression, in the order of `ls`.
+     */
+    [[nodiscard]] std::vector<std::pair<utils::inf_rational, utils::inf_rational>> bounds(const std::vector<utils::lin> &ls, std::size_t n_threads = 1) const noexcept;
+    /**
+     * @brief Returns the current values of many linear expressions at once.
+     *
+     * @param ls The linear expressions whose current values are to be computed.
+     * @param n_threads The number of threads evaluating the expressions (default: 1).
+     * @return The current value of each expression, in the order of `ls`.
+     */
+    [[nodiscard]] std::vector<utils::inf_rational> vals(const std::vector<utils::lin> &ls, std::size_t n_threads = 1) const noexcept;
+    /**
+     * @brief Checks, for many pairs of linear expressions at once, whether they can be made equal.
+     *
+     * This is the batched counterpart of `match`, sharing the gathered bounds of the variables among all the pairs.
+     *
+     * @param ps The pairs of linear expressions to compare.
+     * @param n_threads The number of threads evaluating the pairs (default: 1).
+     * @return For each pair, in the order of `ps`, whether its expressions can be equal.
+     */
+    [[nodiscard]] std::vector<bool> match(const std::vector<std::pair<utils::lin, utils::lin>> &ps, std::size_t n_threads = 1) const noexcept;
+
     friend std::string to_string(const solver &s) noexcept;
     friend json::json to_json(const solver &s) noexcept;
 
   private:
-    [[nodiscard]] bool is_basic(const utils::var v) const noexcept { return tableau.count(v); }
+    /**
+     * @brief A difference `a * (x - y)`, with a positive coefficient `a`.
+     */
+    struct difference
+    {
+      utils::var x, y;  // the variables of the difference..
+      utils::rational a; // the (positive) coefficient of the difference..
+    };
+
+    [[nodiscard]] bool is_basic(const utils::var v) const noexcept { return tableau->is_basic(v); }
+
+    /**
+     * @brief Scales the linear expression `l` into its canonical form, whose coefficients are coprime integers, the first one being positive.
+     *
+     * All the scalings of an expression thus share the same canonical form, hence the same slack variable. The
+     * expressions are normalized once their basic variables have been substituted, since that is the form keying
+     * their slack variables. When the coefficients are too large for being brought to integers, only the sign of the
+     * expression is fixed.
+     *
+     * @param l The linear expression to normalize, whose known term is scaled as well.
+     * @return The scaling factor, one if `l` is left untouched, whose sign tells whether an inequality on `l` is reversed.
+     */
+    static utils::rational normalize(utils::lin &l) noexcept;
 
-    [[nodiscard]] bool set_lb(const utils::var x_i, const utils::inf_rational &v, std::optional<std::reference_wrapper<constraint>> reason = std::nullopt) noexcept;
-    [[nodiscard]] bool set_ub(const utils::var x_i, const utils::inf_rational &v, std::optional<std::reference_wrapper<constraint>> reason = std::nullopt) noexcept;
+    [[nodiscard]] bool set_lb(const utils::var x_i, const utils::inf_rational &v, std::optional<std::reference_wrapper<constraint>> reason = std::nullopt, const utils::rational &scale = utils::rational::one) noexcept;
+    [[nodiscard]] bool set_ub(const utils::var x_i, const utils::inf_rational &v, std::optional<std::reference_wrapper<constraint>> reason = std::nullopt, const utils::rational &scale = utils::rational::one) noexcept;
 
     void update(const utils::var x_i, const utils::inf_rational &v) noexcept;
 
@@ -229,15 +792,416 @@ namespace linspire
     void pivot(const utils::var x_i, const utils::var x_j) noexcept;
 
     void new_row(const utils::var x, utils::lin &&l) noexcept;
+    /**
+     * @brief Creates, or reuses, the slack variable defined by the linear expression `l`, over non-basic variables.
+     *
+     * When `l` is the difference `d`, and every row of the tableau defines a difference, the slack variable is added
+     * to the difference graph alone, without a row. Any other slack variable gets a row, as do, beforehand, the ones
+     * left without.
+     */
+    [[nodiscard]] utils::var new_slack(utils::lin &&l, const std::optional<difference> &d = std::nullopt) noexcept;
+    /**
+     * @brief Removes the row of the slack variable `x`, pivoting `x` back into the basis, if necessary.
+     *
+     * @return The removed row, in terms of the current non-basic variables.
+     */
+    utils::lin remove_slack_row(const utils::var x) noexcept;
+    /**
+     * @brief Removes the row of the slack variable `x`, keeping it aside, if `x` is active, or has no row, and is unbounded.
+     *
+     * Nothing is done if there are backtracking points, since the trail might refer to the row.
+     */
+    void deactivate(const utils::var x) noexcept;
+    /**
+     * @brief Brings back the row of the inactive slack variable `x`, that is about to be bounded.
+     */
+    void reactivate(const utils::var x) noexcept;
+
+    /**
+     * @brief Moves the non-basic variable `x` to its bound `v`, or defers the move until the current batch is committed.
+     */
+    void move_to_bound(const utils::var x, const utils::inf_rational &v) noexcept;
+    /**
+     * @brief Recomputes the values of all the basic variables from their tableau rows, updating the set of violated basic variables.
+     */
+    void recompute_basic_values() noexcept;
+
+    /**
+     * @brief Repairs the bound violations on a floating-point shadow of the tableau and replays the resulting basis in exact arithmetic.
+     *
+     * After the call, the non-basic variables are within their bounds, the basic variables hold their exact values and the
+     * set of violated basic variables is up to date, so that the exact procedure can continue from the replayed basis.
+     */
+    void float_presolve() noexcept;
+    /**
+     * @brief Pivots the fixed basic variables out of the basis, eliminating a non-fixed variable of their rows.
+     *
+     * Fixed basic variables whose rows contain only fixed variables are left in the basis.
+     */
+    void eliminate_fixed() noexcept;
+
+    /**
+     * @brief The role of a variable within the difference graph.
+     */
+    struct difference_var
+    {
+      enum class role
+      {
+        none,      // the variable is not in the graph..
+        vertex,    // the variable is a vertex, whose bounds are edges to and from the zero vertex..
+        difference // the variable is a slack defined by the difference `d`, whose bounds are edges between its variables..
+      } r = role::none;
+      difference d; // the difference defining the slack variable..
+    };
+    /**
+     * @brief Returns the difference represented by the linear expression `l`, if any.
+     */
+    [[nodiscard]] static std::optional<difference> as_difference(const utils::lin &l) noexcept;
+    /**
+     * @brief Returns the difference `d` multiplied by `m`, its variables being swapped when `m` is negative.
+     */
+    [[nodiscard]] static difference scale(const difference &d, const utils::rational &m) noexcept;
+    /**
+     * @brief Returns the linear expression `a * x - a * y` of the difference `d`.
+     */
+    [[nodiscard]] static utils::lin to_lin(const difference &d) noexcept;
+    /**
+     * @brief Checks whether the difference graph is authoritative, i.e., whether every row of the tableau defines a difference.
+     *
+     * While it is, the slack variables of the new differences get no row, and the potentials of the graph solve the
+     * constraints without pivoting.
+     */
+    [[nodiscard]] bool differences_only() const noexcept { return n_d_slacks == tableau->rows().size() + n_d_rowless; }
+    /**
+     * @brief Gives a row to the slack variables of the differences which have none, so that the simplex takes them into account.
+     *
+     * This is required as soon as the tableau gets a row which does not define a difference, and before optimizing or propagating.
+     */
+    void add_difference_rows() noexcept;
+    /**
+     * @brief Adds to the difference graph the slack variable `s`, defined by the difference `d`.
+     *
+     * The slack variable is left out of the graph if any of its variables is a slack defined by a difference, or has
+     * been created after it.
+     *
+     * @return true if the slack variable has been added to the graph, false otherwise.
+     */
+    bool new_difference(const utils::var s, const difference &d) noexcept;
+    /**
+     * @brief Adds to the difference graph, as a vertex, the variable `x`.
+     */
+    void new_vertex(const utils::var x) noexcept;
+    /**
+     * @brief Adds to the difference graph the edges of the variable `x`, according to its role.
+     */
+    void add_difference_edges(const utils::var x) noexcept;
+    /**
+     * @brief Removes from the difference graph the edges of the variable `x`.
+     */
+    void remove_difference(const utils::var x) noexcept;
+    /**
+     * @brief Updates the weights of the edges of the variable `x` to its current bounds.
+     */
+    void update_difference_edges(const utils::var x) noexcept;
+    /**
+     * @brief Checks the difference graph for negative cycles.
+     *
+     * On a negative cycle, the bounds corresponding to its edges are the conflict explanation. Otherwise, if all the
+     * tableau rows define differences, the potentials of the graph are a solution and become the current assignment,
+     * whenever a basic variable, or a slack variable without a row, violates its bounds. The slack variables without a
+     * row are given the values of their differences.
+     *
+     * @return false if the difference constraints are inconsistent, true otherwise.
+     */
+    [[nodiscard]] bool check_differences() noexcept;
+    /**
+     * @brief Runs the simplex procedure of `check(budget)`, stopping with `check_result::unknown` as soon as the rational arithmetic overflows.
+     */
+    [[nodiscard]] check_result simplex(const check_budget &budget) noexcept;
+    /**
+     * @brief Runs the primal simplex procedure of `minimize` from a feasible assignment, stopping as soon as the rational arithmetic overflows.
+     */
+    [[nodiscard]] utils::inf_rational primal_simplex(const utils::lin &l) noexcept;
+
+    /**
+     * @brief Replaces the basic variables of the linear expression `expr` with their corresponding tableau rows.
+     *
+     * @param expr The linear expression, which, after the call, contains only non-basic variables.
+     */
+    void substitute_basic(utils::lin &expr) const noexcept;
+
+    /**
+     * @brief Keeps the set of violated basic variables up to date with respect to the variable `x`.
+     *
+     * This function must be called whenever the value or the bounds of a basic variable change,
+     * or when a variable enters or leaves the basis.
+     *
+     * @param x The variable whose bounds have to be checked.
+     */
+    void update_violation(const utils::var x) noexcept;
+
+    /**
+     * @brief Selects the leaving variable, among the violated basic variables, according to the pivot rule.
+     *
+     * @param bland Whether Bland's rule should be used regardless of the pivot rule.
+     * @return The selected basic variable.
+     */
+    [[nodiscard]] utils::var select_leaving(const bool bland) const noexcept;
+    /**
+     * @brief Selects the entering variable, among the non-basic variables of the row of `x_i`, according to the pivot rule.
+     *
+     * @param x_i The leaving basic variable.
+     * @param increase Whether the value of `x_i` has to be increased (true) or decreased (false).
+     * @param bland Whether Bland's rule should be used regardless of the pivot rule.
+     * @return The selected non-basic variable, or an empty optional if no variable can move `x_i` in the required direction.
+     */
+    [[nodiscard]] std::optional<utils::var> select_entering(const utils::var x_i, const bool increase, const bool bland) const noexcept;
+    /**
+     * @brief Returns the distance of the value of the basic variable `x` from its bounds.
+     *
+     * @param x The basic variable.
+     * @return The amount by which the value of `x` violates its bounds, zero if it is within its bounds.
+     */
+    [[nodiscard]] utils::inf_rational violation(const utils::var x) const noexcept;
+
+    /**
+     * @brief Starts a new conflict explanation.
+     */
+    void new_conflict() noexcept;
+    /**
+     * @brief Adds the constraint `c`, with the (signed) Farkas multiplier `m`, to the conflict explanation.
+     *
+     * The multipliers of a constraint which is added several times are summed up.
+     */
+    void add_to_conflict(const constraint &c, const utils::rational &m) noexcept;
+    /**
+     * @brief Completes the conflict explanation, dropping the constraints whose multipliers cancel out and minimizing it, if required.
+     */
+    void end_conflict() noexcept;
+    /**
+     * @brief Shrinks the conflict explanation to an irreducible one through a deletion-based pass.
+     */
+    void minimize_conflict() noexcept;
+    /**
+     * @brief Checks whether the constraints `cs`, together with the bounds `facts`, are inconsistent, replicating them into the scratch solver `s`.
+     *
+     * The bounds are expressed in terms of the non-basic variables of this solver, so that `s` only contains the
+     * relevant ones. When the constraints are inconsistent, the conflict explanation of `s` refers to the elements of
+     * `s_cs`, which mirror the elements of `cs`. Each mirrored bound is scaled on its own, so that the multipliers of
+     * `s` are already the ones of this solver, even for constraints bounding several variables.
+     *
+     * @param facts The bounds without reason, as (variable, whether it is an upper bound, value) triples.
+     * @param cs The constraints to be checked.
+     * @param s The scratch solver, which must not contain any constraint.
+     * @param s_cs The mirrors of the constraints within `s`, which are created by this function.
+     * @return true if the constraints are proven inconsistent, false otherwise, as when the rational arithmetic of `s` overflows.
+     */
+    [[nodiscard]] bool inconsistent(const std::vector<std::tuple<utils::var, bool, utils::inf_rational>> &facts, const std::vector<const constraint *> &cs, solver &s, std::vector<constraint> &s_cs) const noexcept;
+
+    /**
+     * @brief Adds to the conflict explanation a reason of the most restrictive lower bound of the variable `x`.
+     *
+     * If `x` is basic and its lower bound is implied by its tableau row, the reasons of the bounds of the row are used
+     * instead, as are the ones of the bounds of its difference if `x` has no row.
+     *
+     * @param x The variable whose lower bound has to be explained.
+     * @param m The (positive) Farkas multiplier of the lower bound.
+     */
+    void explain_lb(const utils::var x, const utils::rational &m) noexcept;
+    /**
+     * @brief Adds to the conflict explanation a reason of the most restrictive upper bound of the variable `x`.
+     *
+     * If `x` is basic and its upper bound is implied by its tableau row, the reasons of the bounds of the row are used
+     * instead, as are the ones of the bounds of its difference if `x` has no row.
+     *
+     * @param x The variable whose upper bound has to be explained.
+     * @param m The (positive) Farkas multiplier of the upper bound.
+     */
+    void explain_ub(const utils::var x, const utils::rational &m) noexcept;
+    /**
+     * @brief Adds to the conflict explanation the reasons of the lower bound implied by the tableau row of the basic variable `x`.
+     *
+     * @param x The basic variable whose implied lower bound has to be explained.
+     * @param m The (positive) Farkas multiplier of the implied lower bound.
+     */
+    void explain_implied_lb(const utils::var x, const utils::rational &m) noexcept;
+    /**
+     * @brief Adds to the conflict explanation the reasons of the upper bound implied by the tableau row of the basic variable `x`.
+     *
+     * @param x The basic variable whose implied upper bound has to be explained.
+     * @param m The (positive) Farkas multiplier of the implied upper bound.
+     */
+    void explain_implied_ub(const utils::var x, const utils::rational &m) noexcept;
+
+    /**
+     * @brief A bound derived by the `propagate` procedure, as a combination of the bounds set on the variables.
+     */
+    struct derived_bound
+    {
+      utils::inf_rational v;                                             // the value of the bound..
+      std::vector<std::pair<const constraint *, utils::rational>> coeffs; // the reasons of the bound, with their (signed) Farkas multipliers..
+    };
+
+    struct implied_bounds_cache
+    {
+      utils::inf_rational lb, ub; // the bounds implied by the tableau row..
+      bool valid = false;         // whether the cached bounds are up to date..
+      bool overflow = false;      // whether computing the bounds has overflowed, in which case they are meaningless and ignored..
+    };
+
+    /**
+     * @brief Returns the bounds implied by the tableau row of the basic variable `x`.
+     *
+     * The bounds are computed lazily and cached until a bound of a variable in the row changes or the row is rewritten.
+     * Bounds whose computation overflows are flagged, and the overflow is reported to the calling thread.
+     *
+     * @param x The basic variable whose implied bounds are to be retrieved.
+     * @return The cached implied bounds of the row of `x`.
+     */
+    [[nodiscard]] const implied_bounds_cache &implied_bounds(const utils::var x) const noexcept;
+    /**
+     * @brief Returns the bounds implied by the difference of the slack variable `x`, which has no row.
+     *
+     * The bounds are not cached, since the slack variable is not in the columns of its variables.
+     */
+    [[nodiscard]] implied_bounds_cache difference_bounds(const utils::var x) const noexcept;
+
+    /**
+     * @brief The bounds of the variables occurring in a batch of linear expressions, stored in dense arrays.
+     */
+    struct dense_bounds
+    {
+      std::vector<std::size_t> slot;             // for each variable, its position in the arrays, or `npos` if it does not occur in the batch..
+      std::vector<utils::inf_rational> lbs, ubs; // the lower and upper bounds of the occurring variables..
+      static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+    };
+    /**
+     * @brief Adds the variables of `l` which are not yet in `db` to `db`, along with their bounds.
+     */
+    void gather_bounds(const utils::lin &l, dense_bounds &db) const noexcept;
+    /**
+     * @brief Invalidates the cached implied bounds of the tableau rows watching the variable `x`.
+     *
+     * This function must be called whenever a bound of the variable `x` changes.
+     *
+     * @param x The variable whose bounds have changed.
+     */
+    void invalidate_implied_bounds(const utils::var x) noexcept;
+    /**
+     * @brief Marks the chunk of the variable `x` as changed since the last snapshot.
+     */
+    void touch(const utils::var x) noexcept
+    {
+      if (const auto c = x / solver_snapshot::chunk_size; c < s_dirty.size())
+        s_dirty[c] = true;
+    }
+
+    struct trail_entry
+    {
+      enum class kind
+      {
+        bound, // a new (lower or upper) bound of a variable..
+        slack  // a new slack variable, with its tableau row..
+      } k;
+      utils::var x;                                                                   // the variable..
+      bool upper = false;                                                             // whether the bound is an upper bound..
+      utils::inf_rational v;                                                          // the value of the bound..
+      const constraint *reason = nullptr;                                             // the reason of the bound, if any..
+      bool reason_added = false;                                                      // whether `reason` has been added to the reasons of the bound..
+      bool reason_updated = false;                                                    // whether the bound of `x` stored in `reason` has been updated..
+      bool reactivated = false;                                                       // whether the slack variable already existed, inactive, before getting its row..
+      std::optional<utils::inf_rational> reason_prev;                                 // the previous bound of `x` stored in `reason`, if any..
+      utils::rational scale_prev = utils::rational::one;                              // the previous scale of the bound of `x` stored in `reason`..
+      var::bound_stack erased;                                                        // the bounds removed by a bound without reason..
+      utils::lin expr;                                                                // the expression defined by the slack variable..
+    };
+
+    /**
+     * @brief Records on the trail a new bound of the variable `x`, before it is set.
+     *
+     * This function does nothing if there are no backtracking points.
+     *
+     * @param x The variable.
+     * @param upper Whether the bound is an upper bound.
+     * @param v The value of the bound.
+     * @param reason The reason of the bound, if any.
+     * @param reason_updated Whether the bound of `x` stored in `reason` has been updated.
+     * @param reason_prev The previous bound of `x` stored in `reason`, if any.
+     * @param scale_prev The previous scale of the bound of `x` stored in `reason`.
+     */
+    void trail_bound(const utils::var x, const bool upper, const utils::inf_rational &v, const constraint *reason, const bool reason_updated = false, std::optional<utils::inf_rational> reason_prev = std::nullopt, const utils::rational &scale_prev = utils::rational::one) noexcept;
+    /**
+     * @brief Undoes the change recorded by the trail entry `e`.
+     */
+    void undo(trail_entry &e) noexcept;
+
+    /**
+     * @brief The state of a variable with respect to the slack variables.
+     */
+    enum class slack_state : unsigned char
+    {
+      none,     // the variable is not a slack variable..
+      active,   // the slack variable takes part in the tableau..
+      pinned,   // the slack variable has been created through `new_var`, hence its row is never removed..
+      inactive, // the slack variable is unbounded, hence its row has been removed, while its expression is kept..
+      released, // the variable has been released, hence it is kept fixed until no expression mentions it anymore..
+      difference // the slack variable is defined by a difference, which the graph enforces while all the rows define differences, hence it has no row..
+    };
 
     std::vector<var> vars;                                      // index is the variable id
-    std::unordered_map<std::string, utils::var> exprs;          // the expressions (string to numeric variable) for which already exist slack variables..
-    std::map<utils::var, utils::lin> tableau;                   // basic variable -> expression
-    std::vector<std::set<utils::var>> t_watches;                // for each variable `v`, a set of tableau rows watching `v`..
+    std::vector<slack_state> slacks;                            // for each variable, its state as a slack variable..
+    std::vector<utils::var> free_vars;                          // the identifiers reclaimed by `gc`, to be reused by the new variables..
+    std::unordered_map<utils::var, utils::lin> i_rows;          // the rows of the inactive slack variables, over the variables which were non-basic when removed..
+    cow<expr_table> exprs;                                      // the expressions for which already exist slack variables, shared with the clones until either side changes them..
+    cow<flat_tableau> tableau;                                  // the tableau, with its rows (basic variable -> expression) and columns (variable -> watching rows), shared with the clones until either side changes it..
+    var_set violated;                                           // the basic variables whose value is not within their bounds..
+    mutable std::vector<implied_bounds_cache> r_bounds;         // for each basic variable, the cached bounds implied by its tableau row..
+    std::vector<trail_entry> trail;                             // the undo trail..
+    std::vector<std::size_t> levels;                            // the sizes of the trail at each backtracking point..
+    bool batching = false;                                      // whether a batch of constraint additions is in progress..
+    std::vector<utils::var> pending;                            // the non-basic variables whose value has to be fixed when the batch is committed..
+    pivot_rule p_rule;                                          // the pivot selection strategy..
+    bool f_presolve = false;                                    // whether the `check` procedure starts with a floating-point pre-solve..
+    bool e_fixed = false;                                       // whether the `check` procedure starts by eliminating the fixed basic variables..
+    bool c_minimize = false;                                    // whether the conflict explanations are minimized..
+    bool c_interrupted = false;                                 // whether the last `check` call ran out of budget..
+    std::size_t c_degenerate = 0;                               // the degenerate pivots of the current, possibly interrupted, `check`..
+    bool c_overflowed = false;                                  // whether the last `check`, or optimization, has been stopped by an overflow..
+    bool a_overflow = false;                                    // whether the rational arithmetic of this solver has overflowed since the last `check`..
     std::vector<std::reference_wrapper<const constraint>> cnfl; // the last conflict explanation..
+    std::vector<utils::rational> cnfl_coeffs;                   // the Farkas multipliers of the last conflict explanation..
+    std::unordered_map<const constraint *, std::size_t> cnfl_idx; // the position of each constraint within the conflict explanation being built..
+    std::vector<implied_bound> i_bounds;                        // the bounds derived by the last `propagate` call..
+    difference_graph d_graph;                                   // the difference constraints, with the variable `x` as vertex `x + 1`, the lower and upper bound of `x` as edges `2x` and `2x + 1`..
+    std::vector<difference_var> d_vars;                         // for each variable, its role within the difference graph..
+    std::size_t n_d_slacks = 0;                                 // the number of slack variables defined by a difference..
+    std::size_t n_d_rowless = 0;                                // the number of slack variables defined by a difference which have no row..
+    mutable std::vector<std::shared_ptr<const solver_snapshot::chunk>> s_chunks; // the chunks of the last snapshot..
+    mutable std::vector<bool> s_dirty;                                      // for each chunk, whether it has changed since the last snapshot..
+#ifdef LINSPIRE_ENABLE_STATISTICS
+    statistics c_stats; // the collected statistics..
+#endif
+#ifdef LINSPIRE_ENABLE_TRACE
+    trace_buffer c_trace; // the most recent events..
+#endif
 #ifdef LINSPIRE_ENABLE_LISTENERS
-    std::unordered_map<utils::var, std::set<listener *>> listening; // for each variable, the listeners listening to it..
-    std::set<listener *> listeners;                                 // the collection of listeners..
+    /**
+     * @brief The listeners of a variable.
+     */
+    struct var_listeners
+    {
+      std::vector<listener *> ls; // the listeners listening to the variable..
+      bool dirty = false;         // whether the value of the variable has changed since the last (deferred) notification..
+    };
+    /**
+     * @brief Notifies the listeners of the variable `x` that its value has changed, or marks `x` if the notifications are deferred.
+     */
+    void fire_on_value_changed(const utils::var x) noexcept;
+
+    std::vector<var_listeners> listening; // for each variable, the listeners listening to it..
+    std::vector<listener *> listeners;    // the collection of listeners..
+    bool deferred = false;                // whether the value change notifications are deferred..
+    std::vector<utils::var> dirty;        // the listened variables whose value has changed since the last (deferred) notification..
 #endif
   };
 
@@ -246,37 +1210,79 @@ namespace linspire
     friend class solver;
 
   private:
-    std::map<utils::var, utils::inf_rational> lbs, ubs;
+    /**
+     * @brief Returns the factor scaling the expression of this constraint into the variable `x` it bounds from below or above.
+     *
+     * The Farkas multipliers of the bound on `x` are multiplied by this factor, so that they refer to the constraint as written.
+     */
+    [[nodiscard]] const utils::rational &scale(const utils::var x, const bool upper) const noexcept
+    {
+      const auto &ss = upper ? u_scales : l_scales;
+      const auto it = ss.find(x);
+      return it != ss.end() ? it->second : utils::rational::one;
+    }
+    void set_scale(const utils::var x, const bool upper, const utils::rational &s) noexcept
+    {
+      auto &ss = upper ? u_scales : l_scales;
+      if (s == utils::rational::one)
+        ss.erase(x);
+      else
+        ss[x] = s;
+    }
+
+  private:
+    std::map<utils::var, utils::inf_rational, std::less<utils::var>, pool_allocator<std::pair<const utils::var, utils::inf_rational>>> lbs, ubs;
+    std::map<utils::var, utils::rational, std::less<utils::var>, pool_allocator<std::pair<const utils::var, utils::rational>>> l_scales, u_scales; // the scales of the bounds, when other than one..
   };
 
 #ifdef LINSPIRE_ENABLE_LISTENERS
   class listener
   {
+    friend class solver;
+
   public:
-    explicit listener(solver &slv) noexcept : slv(slv) { slv.listeners.insert(this); }
+    explicit listener(solver &slv) noexcept : slv(slv) { slv.listeners.push_back(this); }
     virtual ~listener() noexcept
     {
       for (const auto &v : listened_vars)
       {
-        slv.listening[v].erase(this);
-        if (slv.listening[v].empty())
-          slv.listening.erase(v);
+        auto &ls = slv.listening[v].ls;
+        ls.erase(std::find(ls.begin(), ls.end(), this));
       }
-      slv.listeners.erase(this);
+      slv.listeners.erase(std::find(slv.listeners.begin(), slv.listeners.end(), this));
     }
 
     virtual void on_value_changed(const utils::var v) noexcept = 0;
+    /**
+     * @brief Called at the end of the `check` procedure, when the notifications are deferred, with the listened variables whose value has changed.
+     *
+     * By default, `on_value_changed` is called for each of the variables.
+     */
+    virtual void on_values_changed(const std::vector<utils::var> &vs) noexcept
+    {
+      for (const auto &v : vs)
+        on_value_changed(v);
+    }
+    /**
+     * @brief Called when the `propagate` procedure derives a tighter bound for the variable `v`.
+     */
+    virtual void on_bound_propagated([[maybe_unused]] const utils::var v) noexcept {}
 
   protected:
     void listen(const utils::var v) noexcept
     {
-      if (listened_vars.insert(v).second)
-        slv.listening[v].insert(this);
+      if (std::find(listened_vars.cbegin(), listened_vars.cend(), v) != listened_vars.cend())
+        return;
+      listened_vars.push_back(v);
+      if (slv.listening.size() <= v)
+        slv.listening.resize(v + 1);
+      slv.listening[v].ls.push_back(this);
     }
 
   private:
     solver &slv;
-    std::set<utils::var> listened_vars;
+    std::vector<utils::var> listened_vars;
+    std::vector<utils::var> changed; // the listened variables whose value has changed, collected for the deferred notification..
   };
 #endif
 
@@ -285,4 +1291,8 @@ namespace linspire
   [[nodiscard]] json::json to_json(const utils::rational &r) noexcept;
   [[nodiscard]] json::json to_json(const utils::inf_rational &r) noexcept;
   [[nodiscard]] json::json to_json(const utils::lin &l) noexcept;
+  [[nodiscard]] json::json to_json(const memory_report &r) noexcept;
+#ifdef LINSPIRE_ENABLE_STATISTICS
+  [[nodiscard]] json::json to_json(const statistics &s) noexcept;
+#endif
 } // namespace linspire
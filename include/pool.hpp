@@ -0,0 +1,174 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace linspire
+{
+  /**
+   * @brief A thread-local free list of memory blocks of a fixed size.
+   *
+   * Deallocated blocks are kept for later allocations of the same size instead of being returned to the system, so
+   * that node-based containers which repeatedly insert and erase elements do not hit the global allocator in steady
+   * state. At most `max_blocks` blocks are kept; the others are returned to the system.
+   */
+  class block_pool
+  {
+  public:
+    static constexpr std::size_t max_blocks = 1 << 16;
+
+    enum class state : unsigned char
+    {
+      uninitialized,
+      alive,
+      destroyed
+    };
+
+    block_pool(const std::size_t size, state &st) noexcept : size(size < sizeof(block) ? sizeof(block) : size), st(st)
+    {
+      pools().push_back(this);
+      st = state::alive;
+    }
+    block_pool(const block_pool &) = delete;
+    ~block_pool() noexcept
+    {
+      release();
+      st = state::destroyed;
+      auto &ps = pools();
+      for (auto it = ps.begin(); it != ps.end(); ++it)
+        if (*it == this)
+        {
+          ps.erase(it);
+          break;
+        }
+    }
+
+    [[nodiscard]] void *allocate()
+    {
+      if (head)
+      { // we reuse a free block..
+        auto b = head;
+        head = b->next;
+        --n_free;
+        return b;
+      }
+      return ::operator new(size);
+    }
+    void deallocate(void *ptr) noexcept
+    {
+      if (n_free >= max_blocks)
+      {
+        ::operator delete(ptr);
+        return;
+      }
+      auto b = static_cast<block *>(ptr);
+      b->next = head;
+      head = b;
+      ++n_free;
+    }
+
+    /**
+     * @brief Returns the free blocks to the system.
+     */
+    void release() noexcept
+    {
+      while (head)
+      {
+        auto b = head;
+        head = b->next;
+        ::operator delete(b);
+      }
+      n_free = 0;
+    }
+
+    /**
+     * @brief Returns the number of free blocks kept by the pool.
+     */
+    [[nodiscard]] std::size_t free_blocks() const noexcept { return n_free; }
+
+    /**
+     * @brief Returns the free blocks of all the pools of the calling thread to the system.
+     */
+    static void release_all() noexcept
+    {
+      for (auto p : pools())
+        p->release();
+    }
+
+    /**
+     * @brief Returns the pool of the calling thread for blocks of `Size` bytes.
+     *
+     * @return A pointer to the pool, or nullptr if the pool has already been destroyed because the thread is exiting.
+     */
+    template <std::size_t Size>
+    [[nodiscard]] static block_pool *get() noexcept
+    {
+      thread_local state st = state::uninitialized; // trivially destructible, hence still accessible after the pool has been destroyed..
+      if (st == state::destroyed)
+        return nullptr;
+      thread_local block_pool pool(Size, st);
+      return &pool;
+    }
+
+  private:
+    struct block
+    {
+      block *next;
+    };
+
+    [[nodiscard]] static std::vector<block_pool *> &pools() noexcept
+    {
+      thread_local std::vector<block_pool *> ps;
+      return ps;
+    }
+
+  private:
+    const std::size_t size;
+    state &st;
+    block *head = nullptr;
+    std::size_t n_free = 0;
+  };
+
+  /**
+   * @brief A stateless allocator drawing single objects from the thread-local block pools.
+   *
+   * It is meant for the nodes of the node-based containers of the solver. Arrays are allocated through the global allocator.
+   */
+  template <typename T>
+  class pool_allocator
+  {
+  public:
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    pool_allocator() noexcept = default;
+    template <typename U>
+    pool_allocator(const pool_allocator<U> &) noexcept {}
+
+    [[nodiscard]] T *allocate(const std::size_t n)
+    {
+      static_assert(alignof(T) <= alignof(std::max_align_t), "over-aligned types are not supported");
+      if (n == 1)
+        if (auto pool = block_pool::get<sizeof(T)>())
+          return static_cast<T *>(pool->allocate());
+      return static_cast<T *>(::operator new(n * sizeof(T)));
+    }
+    void deallocate(T *ptr, const std::size_t n) noexcept
+    {
+      if (n == 1)
+        if (auto pool = block_pool::get<sizeof(T)>())
+        {
+          pool->deallocate(ptr);
+          return;
+        }
+      ::operator delete(ptr);
+    }
+
+    template <typename U>
+    friend bool operator==(const pool_allocator &, const pool_allocator<U> &) noexcept { return true; }
+    template <typename U>
+    friend bool operator!=(const pool_allocator &, const pool_allocator<U> &) noexcept { return false; }
+  };
+} // namespace linspire
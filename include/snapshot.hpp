@@ -0,0 +1,74 @@
+#pragma once
+
+#include "lin.hpp"
+#include "inf_rational.hpp"
+#include <memory>
+#include <vector>
+
+namespace linspire
+{
+  /**
+   * @brief An immutable view of the values and of the bounds of the variables of a solver.
+   *
+   * The variables are stored in fixed-size chunks, shared among the snapshots taken from the same solver, so that
+   * taking a new snapshot only copies the chunks whose variables have changed since the previous one. Since neither
+   * the snapshot nor its chunks are ever modified, any number of threads can query a snapshot without locking, while
+   * the solver keeps being modified by its own thread.
+   */
+  class solver_snapshot
+  {
+  public:
+    static constexpr std::size_t chunk_size = 64; // the number of variables of a chunk..
+
+    /**
+     * @brief The values and the bounds of the variables of a chunk.
+     */
+    struct chunk
+    {
+      std::vector<utils::inf_rational> vals, lbs, ubs;
+    };
+
+    solver_snapshot() noexcept = default;
+    explicit solver_snapshot(std::vector<std::shared_ptr<const chunk>> chunks, const std::size_t n_vars) noexcept : chunks(std::move(chunks)), n_vars(n_vars) {}
+
+    /**
+     * @brief Returns the number of variables of the snapshot.
+     */
+    [[nodiscard]] std::size_t size() const noexcept { return n_vars; }
+
+    /**
+     * @brief Returns the lower bound of the variable `x`, as it was when the snapshot was taken.
+     */
+    [[nodiscard]] const utils::inf_rational &lb(const utils::var x) const noexcept { return chunks[x / chunk_size]->lbs[x % chunk_size]; }
+    /**
+     * @brief Returns the upper bound of the variable `x`, as it was when the snapshot was taken.
+     */
+    [[nodiscard]] const utils::inf_rational &ub(const utils::var x) const noexcept { return chunks[x / chunk_size]->ubs[x % chunk_size]; }
+    /**
+     * @brief Returns the value of the variable `x`, as it was when the snapshot was taken.
+     */
+    [[nodiscard]] const utils::inf_rational &val(const utils::var x) const noexcept { return chunks[x / chunk_size]->vals[x % chunk_size]; }
+
+    /**
+     * @brief Returns the lower bound of the linear expression `l`.
+     */
+    [[nodiscard]] utils::inf_rational lb(const utils::lin &l) const noexcept;
+    /**
+     * @brief Returns the upper bound of the linear expression `l`.
+     */
+    [[nodiscard]] utils::inf_rational ub(const utils::lin &l) const noexcept;
+    /**
+     * @brief Returns the value of the linear expression `l`.
+     */
+    [[nodiscard]] utils::inf_rational val(const utils::lin &l) const noexcept;
+
+    /**
+     * @brief Checks if the linear expressions `l0` and `l1` can be made equal, according to the bounds of the snapshot.
+     */
+    [[nodiscard]] bool match(const utils::lin &l0, const utils::lin &l1) const noexcept;
+
+  private:
+    std::vector<std::shared_ptr<const chunk>> chunks; // the chunks of the variables..
+    std::size_t n_vars = 0;                           // the number of variables..
+  };
+} // namespace linspire
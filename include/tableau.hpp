@@ -0,0 +1,223 @@
+#pragma once
+
+#include "lin.hpp"
+#include <vector>
+#include <limits>
+
+namespace linspire
+{
+  /**
+   * @brief A sparse tableau whose rows and columns are stored in contiguous memory.
+   *
+   * Each row is identified by a dense row id and associates a basic variable with a linear combination of non-basic
+   * variables, stored as an array of terms sorted by variable. Each column stores, in a flat array, the occurrences of
+   * the corresponding (non-basic) variable within the rows. Terms and occurrences point to each other, so that a term
+   * can be reached from its column and an occurrence can be removed from its column in constant time.
+   *
+   * The tableau is parametrized by the type of its coefficients, so that the exact (`utils::rational`) tableau of the
+   * solver can be shadowed by a floating-point (`double`) copy sharing the same layout and pivoting procedure.
+   *
+   * @tparam T The type of the coefficients.
+   */
+  template <typename T>
+  class basic_tableau
+  {
+    template <typename>
+    friend class basic_tableau;
+
+  public:
+    static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+    struct term
+    {
+      utils::var v;        // the (non-basic) variable..
+      T c;                 // the coefficient of the variable..
+      std::size_t col_pos; // the position of the corresponding occurrence in the column of `v`..
+    };
+
+    struct occurrence
+    {
+      std::size_t row; // the id of the row containing the variable..
+      std::size_t pos; // the position of the corresponding term within the row..
+    };
+
+    struct row
+    {
+      utils::var basic;        // the basic variable..
+      std::vector<term> terms; // the terms of the row, sorted by variable..
+    };
+
+    basic_tableau() noexcept = default;
+    /**
+     * @brief Creates a copy of the `other` tableau, converting its coefficients through `conv`.
+     *
+     * @param other The tableau to copy.
+     * @param conv The function converting the coefficients of `other` into coefficients of this tableau.
+     */
+    template <typename U, typename Conv>
+    basic_tableau(const basic_tableau<U> &other, Conv &&conv) noexcept : row_of(other.row_of), columns(other.columns.size())
+    {
+      t_rows.reserve(other.t_rows.size());
+      for (const auto &r : other.t_rows)
+      {
+        auto &rw = t_rows.emplace_back();
+        rw.basic = r.basic;
+        rw.terms.reserve(r.terms.size());
+        for (const auto &t : r.terms)
+          rw.terms.push_back({t.v, conv(t.c), t.col_pos});
+      }
+      for (std::size_t v = 0; v < columns.size(); ++v)
+      {
+        columns[v].reserve(other.columns[v].size());
+        for (const auto &o : other.columns[v])
+          columns[v].push_back({o.row, o.pos});
+      }
+    }
+
+    /**
+     * @brief Makes room for a new variable, which is initially non-basic and does not appear in any row.
+     */
+    void add_var() noexcept
+    {
+      row_of.push_back(npos);
+      columns.emplace_back();
+    }
+
+    /**
+     * @brief Removes the last variable, which must be non-basic and must not appear in any row.
+     */
+    void pop_var() noexcept;
+
+    /**
+     * @brief Checks whether the variable `v` is basic.
+     *
+     * @param v The variable to check.
+     * @return true if `v` is basic, false otherwise.
+     */
+    [[nodiscard]] bool is_basic(const utils::var v) const noexcept { return row_of[v] != npos; }
+
+    /**
+     * @brief Returns the number of rows of the tableau.
+     */
+    [[nodiscard]] std::size_t size() const noexcept { return t_rows.size(); }
+    /**
+     * @brief Returns the rows of the tableau, indexed by row id.
+     */
+    [[nodiscard]] const std::vector<row> &rows() const noexcept { return t_rows; }
+    /**
+     * @brief Returns the row whose basic variable is `x`.
+     *
+     * @param x The basic variable.
+     * @return A constant reference to the row of `x`.
+     */
+    [[nodiscard]] const row &row_of_basic(const utils::var x) const noexcept { return t_rows[row_of[x]]; }
+    /**
+     * @brief Returns the terms of the row whose basic variable is `x`.
+     *
+     * @param x The basic variable.
+     * @return A constant reference to the terms of the row of `x`, sorted by variable.
+     */
+    [[nodiscard]] const std::vector<term> &terms(const utils::var x) const noexcept { return t_rows[row_of[x]].terms; }
+    /**
+     * @brief Returns the occurrences of the non-basic variable `v` within the rows.
+     *
+     * @param v The non-basic variable.
+     * @return A constant reference to the occurrences of `v`.
+     */
+    [[nodiscard]] const std::vector<occurrence> &column(const utils::var v) const noexcept { return columns[v]; }
+    /**
+     * @brief Returns the basic variable of the row referred by the occurrence `o`.
+     */
+    [[nodiscard]] utils::var basic(const occurrence &o) const noexcept { return t_rows[o.row].basic; }
+    /**
+     * @brief Returns the coefficient of the term referred by the occurrence `o`.
+     */
+    [[nodiscard]] const T &coeff(const occurrence &o) const noexcept { return t_rows[o.row].terms[o.pos].c; }
+    /**
+     * @brief Returns the coefficient of the non-basic variable `v` in the row whose basic variable is `x`.
+     *
+     * @param x The basic variable.
+     * @param v The non-basic variable.
+     * @return A pointer to the coefficient of `v`, or nullptr if `v` does not appear in the row of `x`.
+     */
+    [[nodiscard]] const T *coeff(const utils::var x, const utils::var v) const noexcept;
+
+    /**
+     * @brief Adds a new row `x = l` to the tableau.
+     *
+     * @param x The new basic variable, which must currently be non-basic and must not appear in any row.
+     * @param l The linear expression, over non-basic variables, defining `x`.
+     * @note Available for exact tableaus only.
+     */
+    void add_row(const utils::var x, const utils::lin &l) noexcept;
+
+    /**
+     * @brief Removes the row whose basic variable is `x`, which becomes a non-basic variable not appearing in any row.
+     *
+     * The last row takes the id of the removed row.
+     *
+     * @param x The basic variable.
+     */
+    void remove_row(const utils::var x) noexcept;
+
+    /**
+     * @brief Rewrites the row of the basic variable `x_i` as a row of the non-basic variable `x_j` and substitutes `x_j` in all the other rows.
+     *
+     * @param x_i The leaving basic variable.
+     * @param x_j The entering non-basic variable.
+     * @return The ids of the rows, other than the row of `x_j`, which have been rewritten, valid until the next pivot.
+     */
+    const std::vector<std::size_t> &pivot(const utils::var x_i, const utils::var x_j) noexcept;
+
+    /**
+     * @brief Returns the linear expression of the row whose basic variable is `x`.
+     *
+     * @param x The basic variable.
+     * @return The linear expression defining `x`.
+     * @note Available for exact tableaus only.
+     */
+    [[nodiscard]] utils::lin to_lin(const utils::var x) const noexcept;
+
+    /**
+     * @brief Releases the unused capacity of the rows, of the columns and of the internal buffers.
+     */
+    void compact() noexcept;
+
+    /**
+     * @brief Returns the number of bytes allocated by the rows, the columns and the internal buffers, including their unused capacity.
+     */
+    [[nodiscard]] std::size_t memory_usage() const noexcept
+    {
+      std::size_t bytes = t_rows.capacity() * sizeof(row) + row_of.capacity() * sizeof(std::size_t) + columns.capacity() * sizeof(std::vector<occurrence>);
+      for (const auto &r : t_rows)
+        bytes += r.terms.capacity() * sizeof(term);
+      for (const auto &c : columns)
+        bytes += c.capacity() * sizeof(occurrence);
+      bytes += scratch_terms.capacity() * sizeof(term) + scratch_occs.capacity() * sizeof(occurrence);
+      bytes += scratch_removed.capacity() * sizeof(std::pair<utils::var, std::size_t>) + touched.capacity() * sizeof(std::size_t);
+      return bytes;
+    }
+
+  private:
+    void remove_occurrence(const utils::var v, const std::size_t col_pos) noexcept;
+    void reindex(const std::size_t r) noexcept;
+
+  private:
+    std::vector<row> t_rows;                     // the rows of the tableau, indexed by row id..
+    std::vector<std::size_t> row_of;             // for each variable, the id of the row in which it is basic (`npos` if non-basic)..
+    std::vector<std::vector<occurrence>> columns; // for each variable, its occurrences within the rows..
+    // the buffers reused across pivots..
+    std::vector<term> scratch_terms;
+    std::vector<occurrence> scratch_occs;
+    std::vector<std::pair<utils::var, std::size_t>> scratch_removed;
+    std::vector<std::size_t> touched;
+  };
+
+  template <>
+  void basic_tableau<utils::rational>::add_row(const utils::var x, const utils::lin &l) noexcept;
+  template <>
+  utils::lin basic_tableau<utils::rational>::to_lin(const utils::var x) const noexcept;
+
+  using flat_tableau = basic_tableau<utils::rational>; // the exact tableau..
+  using float_tableau = basic_tableau<double>;         // the floating-point shadow of the exact tableau..
+} // namespace linspire
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "json.hpp"
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace linspire
+{
+  /**
+   * @brief A compact event recorded by the solver.
+   */
+  struct trace_event
+  {
+    enum class kind : std::uint8_t
+    {
+      pivot,       // `x` leaves the basis, `y` enters it..
+      lower_bound, // a new lower bound of `x`..
+      upper_bound, // a new upper bound of `x`..
+      update,      // the value of the non-basic variable `x` is updated..
+      conflict     // a conflict explanation with `x` constraints..
+    };
+    static constexpr std::uint64_t none = std::numeric_limits<std::uint64_t>::max();
+
+    std::uint64_t time; // the nanoseconds elapsed since the epoch of the steady clock..
+    std::uint64_t x;    // the first argument of the event..
+    std::uint64_t y;    // the second argument of the event, if any, `none` otherwise..
+    kind k;             // the kind of the event..
+  };
+
+  /**
+   * @brief A fixed-size ring buffer of trace events.
+   *
+   * Recording an event takes a clock read and a few stores, with no allocation, so that the buffer can be kept on in
+   * production and dumped after a slow `check`. Once full, the oldest events are overwritten.
+   */
+  class trace_buffer
+  {
+  public:
+    /**
+     * @brief Creates a buffer keeping the last `capacity` events, rounded up to a power of two.
+     */
+    explicit trace_buffer(const std::size_t capacity = 1024) noexcept { set_capacity(capacity); }
+
+    /**
+     * @brief Records an event of kind `k`, with arguments `x` and `y`.
+     */
+    void record(const trace_event::kind k, const std::uint64_t x, const std::uint64_t y = trace_event::none) noexcept
+    {
+      auto &e = events[n_recorded++ & mask];
+      e.time = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+      e.x = x;
+      e.y = y;
+      e.k = k;
+    }
+
+    /**
+     * @brief Returns the maximum number of events kept by the buffer.
+     */
+    [[nodiscard]] std::size_t capacity() const noexcept { return events.size(); }
+    /**
+     * @brief Sets the maximum number of events kept by the buffer, rounded up to a power of two, discarding the recorded events.
+     */
+    void set_capacity(const std::size_t capacity) noexcept;
+    /**
+     * @brief Returns the number of events kept by the buffer.
+     */
+    [[nodiscard]] std::size_t size() const noexcept { return n_recorded < events.size() ? static_cast<std::size_t>(n_recorded) : events.size(); }
+    /**
+     * @brief Returns the number of events recorded since the last `clear`, including the overwritten ones.
+     */
+    [[nodiscard]] std::uint64_t recorded() const noexcept { return n_recorded; }
+    /**
+     * @brief Discards the recorded events.
+     */
+    void clear() noexcept { n_recorded = 0; }
+
+    /**
+     * @brief Returns the kept events, from the oldest to the most recent.
+     */
+    [[nodiscard]] std::vector<trace_event> get_events() const noexcept;
+
+    /**
+     * @brief Writes the kept events, from the oldest to the most recent, in binary form.
+     *
+     * The output is the magic string `LSTRACE1`, the number of events as a 64-bit integer, and, for each event, its
+     * time, `x` and `y` as 64-bit integers followed by its kind as a byte, all in the native byte order.
+     *
+     * @param os The (binary) output stream.
+     */
+    void dump(std::ostream &os) const noexcept;
+
+  private:
+    std::vector<trace_event> events; // the ring buffer..
+    std::size_t mask = 0;            // the capacity of the buffer minus one..
+    std::uint64_t n_recorded = 0;    // the number of recorded events..
+  };
+
+  [[nodiscard]] std::string to_string(const trace_event::kind k) noexcept;
+  [[nodiscard]] json::json to_json(const trace_event &e) noexcept;
+  [[nodiscard]] json::json to_json(const trace_buffer &b) noexcept;
+} // namespace linspire
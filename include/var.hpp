@@ -3,7 +3,9 @@
 #include "lin.hpp"
 #include "inf_rational.hpp"
 #include "json.hpp"
+#include "pool.hpp"
 #include <set>
+#include <vector>
 #include <optional>
 #include <functional>
 
@@ -11,15 +13,30 @@ namespace linspire
 {
   class constraint;
 
+  using var_set = std::set<utils::var, std::less<utils::var>, pool_allocator<utils::var>>; // a set of variables..
+
   class var
   {
     friend class solver;
 
   public:
+    /**
+     * @brief A bound of a variable, together with one of its reasons.
+     *
+     * A bound with several reasons is stored as adjacent entries with the same value, a bound without reasons as a
+     * single entry with a null reason.
+     */
+    struct bound
+    {
+      utils::inf_rational v;    // the value of the bound..
+      const constraint *reason; // the reason of the bound, if any..
+    };
+    using bound_stack = std::vector<bound>; // the bounds of a variable, sorted from the least to the most restrictive..
+
     var(const utils::inf_rational &lb = utils::inf_rational(utils::rational::negative_infinite), const utils::inf_rational &ub = utils::inf_rational(utils::rational::positive_infinite)) noexcept;
 
-    [[nodiscard]] utils::inf_rational get_lb() const noexcept;
-    [[nodiscard]] utils::inf_rational get_ub() const noexcept;
+    [[nodiscard]] const utils::inf_rational &get_lb() const noexcept { return lb; }
+    [[nodiscard]] const utils::inf_rational &get_ub() const noexcept { return ub; }
     [[nodiscard]] utils::inf_rational get_val() const noexcept { return val; }
 
     friend std::string to_string(const var &x) noexcept;
@@ -31,9 +48,32 @@ namespace linspire
     void set_ub(const utils::inf_rational &v, std::optional<std::reference_wrapper<const constraint>> reason = std::nullopt) noexcept;
     void unset_ub(const utils::inf_rational &v, const constraint &reason) noexcept;
 
+    /**
+     * @brief Checks whether `reason` is one of the reasons of the (lower or upper) bound `v`.
+     */
+    [[nodiscard]] bool has_reason(const bool upper, const utils::inf_rational &v, const constraint &reason) const noexcept;
+    /**
+     * @brief Returns the oldest reason of the most restrictive (lower or upper) bound.
+     *
+     * @return The reason of the bound, or nullptr if the bound has no reason or the variable is unbounded.
+     */
+    [[nodiscard]] const constraint *bound_reason(const bool upper) const noexcept;
+    /**
+     * @brief Removes the (lower or upper) bound `v`, with all its reasons, and restores the `erased` bounds.
+     *
+     * This is the inverse of setting the bound `v` without reason, which erases all the less restrictive bounds.
+     */
+    void restore_bounds(const bool upper, const utils::inf_rational &v, const bound_stack &erased) noexcept;
+
+    static void add_bound(bound_stack &bs, const bool upper, const utils::inf_rational &v, const constraint *reason) noexcept;
+    static void remove_bound(bound_stack &bs, const bool upper, const utils::inf_rational &v, const constraint *reason) noexcept;
+    void refresh() noexcept;
+
   private:
-    std::map<utils::inf_rational, std::set<const constraint *>> lbs, ubs; // the lower and upper bounds with their reasons..
-    utils::inf_rational val;                                              // the current value of this variable..
+    utils::inf_rational val; // the current value of this variable..
+    utils::inf_rational lb;  // the most restrictive lower bound, kept inline for the hot queries..
+    utils::inf_rational ub;  // the most restrictive upper bound, kept inline for the hot queries..
+    bound_stack lbs, ubs;    // the lower and upper bounds with their reasons..
   };
 
   [[nodiscard]] std::string to_string(const var &x) noexcept;
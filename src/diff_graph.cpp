@@ -0,0 +1,166 @@
+#include "diff_graph.hpp"
+#include "arith.hpp"
+#include <algorithm>
+#include <cassert>
+
+namespace linspire
+{
+    void difference_graph::add_edge(const edge e, const vertex from, const vertex to) noexcept
+    {
+        assert(!has_edge(e));
+        if (e >= edges.size())
+            edges.resize(e + 1);
+        if (const auto n = std::max(from, to) + 1; n > first_out.size())
+        {
+            first_out.resize(n, npos);
+            pi.resize(n, utils::inf_rational(utils::rational::zero));
+            gamma.resize(n);
+            pred.resize(n, npos);
+            state.resize(n, unvisited);
+        }
+        auto &ed = edges[e];
+        ed = edge_data();
+        ed.from = from;
+        ed.to = to;
+        ed.next = first_out[from];
+        if (ed.next != npos)
+            edges[ed.next].prev = e;
+        first_out[from] = e;
+    }
+
+    void difference_graph::remove_edge(const edge e) noexcept
+    {
+        assert(has_edge(e));
+        const auto &ed = edges[e];
+        if (ed.prev != npos)
+            edges[ed.prev].next = ed.next;
+        else
+            first_out[ed.from] = ed.next;
+        if (ed.next != npos)
+            edges[ed.next].prev = ed.prev;
+        edges[e] = edge_data(); // a queued edge is skipped, once removed..
+    }
+
+    void difference_graph::set_weight(const edge e, const utils::inf_rational &w) noexcept
+    {
+        assert(has_edge(e));
+        auto &ed = edges[e];
+        if (!ed.queued && (!ed.active || w < ed.w))
+        { // relaxing an edge keeps the potential function valid, tightening it might not..
+            ed.queued = true;
+            queue.push_back(e);
+        }
+        ed.active = true;
+        ed.w = w;
+    }
+
+    void difference_graph::unset_weight(const edge e) noexcept
+    {
+        assert(has_edge(e));
+        edges[e].active = false;
+    }
+
+    bool difference_graph::check() noexcept
+    {
+        while (!queue.empty())
+        { // the most recent edges are checked first, so that the older queued edges are not visited over and over..
+            if (const auto e = queue.back(); has_edge(e) && edges[e].queued)
+            {
+                if (!check(e))
+                    return false; // we keep the unchecked edges, including the failing one, for the next check..
+                edges[e].queued = false;
+            }
+            queue.pop_back();
+        }
+        return true;
+    }
+
+    bool difference_graph::check(const edge e) noexcept
+    {
+        const auto &ed = edges[e];
+        if (!ed.active)
+            return true; // the edge has been deactivated in the meanwhile..
+        const auto u = ed.from, v = ed.to;
+        if (sub(pi[v], pi[u]) <= ed.w)
+            return true; // the potential function already satisfies the edge..
+
+        // we lower the potentials of the vertices reachable from `v`, in order of decreasing change..
+        const auto cmp = [](const std::pair<utils::inf_rational, vertex> &a, const std::pair<utils::inf_rational, vertex> &b)
+        { return b.first < a.first; };
+        visited.clear();
+        heap.clear();
+        gamma[v] = sub(add(pi[u], ed.w), pi[v]);
+        pred[v] = e;
+        state[v] = reached;
+        visited.push_back(v);
+        heap.emplace_back(gamma[v], v);
+        bool consistent = true;
+        while (consistent && !heap.empty())
+        {
+            std::pop_heap(heap.begin(), heap.end(), cmp);
+            const auto [g, s] = std::move(heap.back());
+            heap.pop_back();
+            if (state[s] == settled || g != gamma[s])
+                continue; // a stale entry..
+            state[s] = settled;
+            const auto pi_s = add(pi[s], g);
+            for (auto f = first_out[s]; f != npos; f = edges[f].next)
+                if (const auto &fd = edges[f]; fd.active && !fd.queued && state[fd.to] != settled)
+                { // the other queued edges are left out, and checked later..
+                    const auto t = fd.to;
+                    const auto d = sub(add(pi_s, fd.w), pi[t]);
+                    if (state[t] == unvisited ? d < utils::inf_rational(utils::rational::zero) : d < gamma[t])
+                    {
+                        if (t == u)
+                        { // the edge `e` closes a negative cycle..
+                            cycle.clear();
+                            cycle.push_back(f);
+                            for (auto x = s; x != v; x = edges[pred[x]].from)
+                                cycle.push_back(pred[x]);
+                            cycle.push_back(e);
+                            consistent = false;
+                            break;
+                        }
+                        if (state[t] == unvisited)
+                        {
+                            state[t] = reached;
+                            visited.push_back(t);
+                        }
+                        gamma[t] = d;
+                        pred[t] = f;
+                        heap.emplace_back(d, t);
+                        std::push_heap(heap.begin(), heap.end(), cmp);
+                    }
+                }
+        }
+
+        for (const auto &x : visited)
+        {
+            if (consistent && state[x] == settled)
+                pi[x] = add(pi[x], gamma[x]);
+            state[x] = unvisited;
+        }
+        return consistent;
+    }
+
+    void difference_graph::compact() noexcept
+    {
+        edges.shrink_to_fit();
+        first_out.shrink_to_fit();
+        pi.shrink_to_fit();
+        queue.shrink_to_fit();
+        cycle = std::vector<edge>();
+        gamma.shrink_to_fit();
+        pred.shrink_to_fit();
+        state.shrink_to_fit();
+        visited = std::vector<vertex>();
+        heap = std::vector<std::pair<utils::inf_rational, vertex>>();
+    }
+
+    std::size_t difference_graph::memory_usage() const noexcept
+    {
+        return edges.capacity() * sizeof(edge_data) + (first_out.capacity() + queue.capacity() + cycle.capacity() + pred.capacity()) * sizeof(edge) +
+               (pi.capacity() + gamma.capacity()) * sizeof(utils::inf_rational) + state.capacity() * sizeof(visit_state) + visited.capacity() * sizeof(vertex) +
+               heap.capacity() * sizeof(std::pair<utils::inf_rational, vertex>);
+    }
+} // namespace linspire
@@ -0,0 +1,128 @@
+#include "expr_table.hpp"
+#include <algorithm>
+#include <cassert>
+#include <functional>
+
+namespace linspire
+{
+    static inline void hash_combine(std::size_t &h, const std::size_t v) noexcept { h ^= v + 0x9e3779b9 + (h << 6) + (h >> 2); }
+
+    std::size_t expr_table::memory_usage() const noexcept
+    {
+        std::size_t bytes = slots.capacity() * sizeof(slot);
+        for (const auto &s : slots)
+            bytes += s.terms.capacity() * sizeof(std::pair<utils::var, utils::rational>);
+        return bytes;
+    }
+
+    std::optional<utils::var> expr_table::find(const utils::lin &l) const noexcept
+    {
+        if (const auto pos = position(l, hash(l)); pos != slots.size())
+            return slots[pos].slack;
+        return std::nullopt;
+    }
+
+    void expr_table::insert(const utils::lin &l, const utils::var x) noexcept
+    {
+        const auto h = hash(l);
+        assert(position(l, h) == slots.size());
+        if ((n_full + n_deleted + 1) * 4 > slots.size() * 3)
+        { // we keep the load factor, deleted slots included, below 3/4 by rehashing into a table which is at most half full..
+            auto n_slots = std::max<std::size_t>(16, slots.size());
+            while ((n_full + 1) * 2 > n_slots)
+                n_slots *= 2;
+            rehash(n_slots);
+        }
+
+        const auto mask = slots.size() - 1;
+        auto i = h & mask;
+        while (slots[i].state == slot_state::full)
+            i = (i + 1) & mask;
+        auto &s = slots[i];
+        if (s.state == slot_state::deleted)
+            --n_deleted;
+        s.state = slot_state::full;
+        s.hash = h;
+        s.slack = x;
+        s.terms.assign(l.vars.cbegin(), l.vars.cend());
+        s.known_term = l.known_term;
+        ++n_full;
+    }
+
+    bool expr_table::erase(const utils::lin &l) noexcept
+    {
+        const auto pos = position(l, hash(l));
+        if (pos == slots.size())
+            return false;
+        auto &s = slots[pos];
+        s.state = slot_state::deleted;
+        s.terms.clear();
+        --n_full;
+        ++n_deleted;
+        return true;
+    }
+
+    std::size_t expr_table::hash(const utils::lin &l) noexcept
+    {
+        std::size_t h = l.vars.size();
+        for (const auto &[v, c] : l.vars)
+        {
+            hash_combine(h, std::hash<utils::var>{}(v));
+            hash_combine(h, std::hash<decltype(c.numerator())>{}(c.numerator()));
+            hash_combine(h, std::hash<decltype(c.denominator())>{}(c.denominator()));
+        }
+        hash_combine(h, std::hash<decltype(l.known_term.numerator())>{}(l.known_term.numerator()));
+        hash_combine(h, std::hash<decltype(l.known_term.denominator())>{}(l.known_term.denominator()));
+        return h;
+    }
+
+    bool expr_table::equals(const slot &s, const std::size_t h, const utils::lin &l) noexcept
+    {
+        if (s.hash != h || s.terms.size() != l.vars.size() || s.known_term != l.known_term)
+            return false;
+        auto it = l.vars.cbegin();
+        for (const auto &[v, c] : s.terms)
+        {
+            if (v != it->first || c != it->second)
+                return false;
+            ++it;
+        }
+        return true;
+    }
+
+    std::size_t expr_table::position(const utils::lin &l, const std::size_t h) const noexcept
+    {
+        if (slots.empty())
+            return 0;
+        const auto mask = slots.size() - 1;
+        for (auto i = h & mask;; i = (i + 1) & mask)
+            switch (slots[i].state)
+            {
+            case slot_state::empty: // the expression is not in the table..
+                return slots.size();
+            case slot_state::full:
+                if (equals(slots[i], h, l))
+                    return i;
+                break;
+            case slot_state::deleted: // we keep probing..
+                break;
+            }
+    }
+
+    void expr_table::rehash(const std::size_t n_slots) noexcept
+    {
+        assert((n_slots & (n_slots - 1)) == 0);
+        std::vector<slot> old_slots(n_slots);
+        std::swap(old_slots, slots);
+        n_deleted = 0;
+        const auto mask = slots.size() - 1;
+        for (auto &s : old_slots)
+            if (s.state == slot_state::full)
+            {
+                auto i = s.hash & mask;
+                while (slots[i].state == slot_state::full)
+                    i = (i + 1) & mask;
+                slots[i] = std::move(s);
+            }
+    }
+} // namespace linspire
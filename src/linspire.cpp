@@ -1,40 +1,149 @@
 #include "linspire.hpp"
+#include "arith.hpp"
 #include "logging.hpp"
 #include <algorithm>
+#include <array>
 #include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <numeric>
+#include <system_error>
+#include <thread>
+#include <tuple>
 #include <unordered_map>
+#include <utility>
 
 #ifdef LINSPIRE_ENABLE_LISTENERS
-#define FIRE_ON_VALUE_CHANGED(var)                                       \
-    if (const auto &at_v = listening.find(var); at_v != listening.end()) \
-        for (auto &l : at_v->second)                                     \
-            l->on_value_changed(var);
+#define FIRE_ON_VALUE_CHANGED(var) fire_on_value_changed(var)
+#define FLUSH_NOTIFICATIONS() flush_notifications()
 #else
 #define FIRE_ON_VALUE_CHANGED(var)
+#define FLUSH_NOTIFICATIONS()
+#endif
+
+#ifdef LINSPIRE_ENABLE_STATISTICS
+#define STAT_INC(counter) ++c_stats.counter
+#define STAT_ADD(counter, n) c_stats.counter += n
+#define STAT_TIMER(counter) const stat_timer counter##_timer(c_stats.counter)
+#else
+#define STAT_INC(counter)
+#define STAT_ADD(counter, n)
+#define STAT_TIMER(counter)
+#endif
+
+#ifdef LINSPIRE_ENABLE_TRACE
+#define TRACE_EVENT(k, ...) c_trace.record(trace_event::kind::k, __VA_ARGS__)
+#else
+#define TRACE_EVENT(k, ...)
 #endif
 
 namespace linspire
 {
+#ifdef LINSPIRE_ENABLE_STATISTICS
+    /**
+     * @brief Adds to a cumulative duration the time elapsed between its construction and its destruction.
+     */
+    class stat_timer
+    {
+    public:
+        explicit stat_timer(std::chrono::nanoseconds &acc) noexcept : acc(acc), start(std::chrono::steady_clock::now()) {}
+        ~stat_timer() noexcept { acc += std::chrono::steady_clock::now() - start; }
+
+    private:
+        std::chrono::nanoseconds &acc;
+        const std::chrono::steady_clock::time_point start;
+    };
+#endif
+
+    /**
+     * @brief Collects into `overflow` the overflows of the rational arithmetic between its construction and its destruction.
+     *
+     * The overflows of the enclosing computation, which might belong to another solver, are set aside meanwhile.
+     */
+    class overflow_scope
+    {
+    public:
+        explicit overflow_scope(bool &overflow) noexcept : overflow(overflow), outer(std::exchange(arith_overflow, false)) {}
+        ~overflow_scope() noexcept
+        {
+            overflow = overflow || arith_overflow;
+            arith_overflow = outer;
+        }
+
+    private:
+        bool &overflow;   // the overflow state receiving the overflows of the scope..
+        const bool outer; // the overflow state of the enclosing computation..
+    };
+
     utils::var solver::new_var(const utils::inf_rational &lb, const utils::inf_rational &ub) noexcept
     {
         assert(lb <= ub);
+        if (!free_vars.empty())
+        { // we reuse an identifier reclaimed by `gc`..
+            const auto x = free_vars.back();
+            free_vars.pop_back();
+            vars[x] = var(lb, ub);
+            touch(x);
+            return x;
+        }
         const auto x = vars.size();
         vars.emplace_back(lb, ub);
-        t_watches.emplace_back();
+        slacks.push_back(slack_state::none);
+        tableau.write().add_var();
+        r_bounds.emplace_back();
         return x;
     }
 
     utils::var solver::new_var(utils::lin &&l) noexcept
+    {
+        const overflow_scope scope(a_overflow);
+        const auto x = new_slack(std::move(l));
+        slacks[x] = slack_state::pinned; // the caller might refer to `x`, hence its row is kept..
+        return x;
+    }
+
+    utils::var solver::new_slack(utils::lin &&l, const std::optional<difference> &d) noexcept
     {
         assert(l.vars.size() > 1);
-        const auto s_expr = to_string(l);
-        if (const auto it = exprs.find(s_expr); it != exprs.cend()) // we already have a slack variable for this expression..
-            return it->second;
+        if (const auto x = exprs->find(l); x)
+        { // we already have a slack variable for this expression..
+            STAT_INC(n_reused_slacks);
+            if (slacks[*x] == slack_state::inactive)
+                reactivate(*x);
+            else if (slacks[*x] == slack_state::difference && !d)
+                add_difference_rows(); // the caller expects a row..
+            return *x;
+        }
         // we create a new slack variable for this expression..
         utils::var slack = new_var();
         vars[slack].val = val(l);
-        exprs.emplace(s_expr, slack);
+        touch(slack);
+        slacks[slack] = slack_state::active;
+        exprs.write().insert(l, slack);
+        if (!levels.empty())
+        { // we record the new slack variable, so that it can be removed when backtracking..
+            auto &e = trail.emplace_back();
+            e.k = trail_entry::kind::slack;
+            e.x = slack;
+            e.expr = l;
+        }
+        if (d && differences_only() && new_difference(slack, *d))
+        { // the graph alone enforces the difference..
+            slacks[slack] = slack_state::difference;
+            ++n_d_rowless;
+            return slack;
+        }
+        if (n_d_rowless)
+        { // the simplex is about to take over from the graph, and the slack variables getting a row might appear in `l`..
+            add_difference_rows();
+            substitute_basic(l);
+        }
         new_row(slack, std::move(l));
+        if (d)
+            new_difference(slack, *d);
         return slack;
     }
 
@@ -42,8 +151,13 @@ namespace linspire
     {
         if (is_basic(x))
         {
-            auto l = lb(tableau.at(x));
-            return l > vars[x].get_lb() ? l : vars[x].get_lb();
+            const auto &ib = implied_bounds(x);
+            return !ib.overflow && ib.lb > vars[x].get_lb() ? ib.lb : vars[x].get_lb();
+        }
+        else if (slacks[x] == slack_state::difference)
+        {
+            const auto db = difference_bounds(x);
+            return !db.overflow && db.lb > vars[x].get_lb() ? db.lb : vars[x].get_lb();
         }
         else
             return vars[x].get_lb();
@@ -52,8 +166,13 @@ namespace linspire
     {
         if (is_basic(x))
         {
-            auto u = ub(tableau.at(x));
-            return u < vars[x].get_ub() ? u : vars[x].get_ub();
+            const auto &ib = implied_bounds(x);
+            return !ib.overflow && ib.ub < vars[x].get_ub() ? ib.ub : vars[x].get_ub();
+        }
+        else if (slacks[x] == slack_state::difference)
+        {
+            const auto db = difference_bounds(x);
+            return !db.overflow && db.ub < vars[x].get_ub() ? db.ub : vars[x].get_ub();
         }
         else
             return vars[x].get_ub();
@@ -62,20 +181,13 @@ namespace linspire
 
     bool solver::new_eq(const utils::lin &lhs, const utils::lin &rhs, std::optional<std::reference_wrapper<constraint>> reason) noexcept
     {
+        const overflow_scope scope(a_overflow);
         LOG_TRACE(utils::to_string(lhs) + " == " + utils::to_string(rhs));
-        utils::lin expr = lhs - rhs;
-        // we remove the basic variables from the expression and replace them with their corresponding linear expressions in the tableau
-        std::vector<utils::var> vs;
-        vs.reserve(expr.vars.size());
-        for ([[maybe_unused]] const auto &[x, c] : expr.vars)
-            vs.push_back(x);
-        for (const auto &v : vs)
-            if (tableau.find(v) != tableau.cend())
-            {
-                auto c = expr.vars.at(v);
-                expr.vars.erase(v);
-                expr += c * tableau.at(v);
-            }
+        utils::lin expr = sub(lhs, rhs);
+        const auto diff = as_difference(expr); // the difference is read before the substitution rewrites the variables..
+        const auto a = expr.vars.size() == 1 ? expr.vars.cbegin()->second : utils::rational::one; // the multipliers refer to the expression divided by its coefficient, if it has a single variable..
+        substitute_basic(expr);
+        const auto m = normalize(expr); // the scalings of the same hyperplane share the same slack variable, whatever their sign..
 
         switch (expr.vars.size())
         {
@@ -85,61 +197,61 @@ namespace linspire
         {
             const auto [x, c] = *expr.vars.cbegin();
             assert(c != 0);
-            const utils::inf_rational c_right = utils::inf_rational(-expr.known_term) / c; // the right-hand side of the constraint is the division of the negation of the known term by the coefficient..
+            const utils::inf_rational c_right = div(utils::inf_rational(neg(expr.known_term)), c); // the right-hand side of the constraint is the division of the negation of the known term by the coefficient..
             // we can set both the lower and upper bound of the variable to the right-hand side of the constraint..
-            return set_lb(x, c_right, reason) && set_ub(x, c_right, reason);
+            const auto sc = mul(div(m, c), a); // `x` is `expr` scaled by `m / c`, up to a constant, hence so are the multipliers of its bound..
+            return set_lb(x, c_right, reason, sc) && set_ub(x, c_right, reason, sc);
         }
         default: // the expression is still a general linear expression..
-            const utils::inf_rational c_right = utils::inf_rational(-expr.known_term);
+            const utils::inf_rational c_right = utils::inf_rational(neg(expr.known_term));
             expr.known_term = utils::rational::zero;
-            // we add the expression to the tableau, associating it with a new (slack) variable
-            utils::var slack = new_var(std::move(expr));
-            return set_lb(slack, c_right, reason) && set_ub(slack, c_right, reason);
+            // we add the expression to the tableau, associating it with a new (slack) variable, which is also an edge of the difference graph, scaled as its expression, if it defines a difference..
+            utils::var slack = new_slack(std::move(expr), diff ? std::optional<difference>(scale(*diff, m)) : std::nullopt);
+            const auto sc = mul(m, a);
+            return set_lb(slack, c_right, reason, sc) && set_ub(slack, c_right, reason, sc);
         }
     }
     bool solver::new_lt(const utils::lin &lhs, const utils::lin &rhs, bool strict, std::optional<std::reference_wrapper<constraint>> reason) noexcept
     {
+        const overflow_scope scope(a_overflow);
         LOG_TRACE(utils::to_string(lhs) + (strict ? " < " : " <= ") + utils::to_string(rhs));
-        utils::lin expr = lhs - rhs;
-        // we remove the basic variables from the expression and replace them with their corresponding linear expressions in the tableau
-        std::vector<utils::var> vs;
-        vs.reserve(expr.vars.size());
-        for ([[maybe_unused]] const auto &[x, c] : expr.vars)
-            vs.push_back(x);
-        for (const auto &x : vs)
-            if (tableau.find(x) != tableau.cend())
-            {
-                auto c = expr.vars.at(x);
-                expr.vars.erase(x);
-                expr += c * tableau.at(x);
-            }
+        utils::lin expr = sub(lhs, rhs);
+        const auto diff = as_difference(expr); // the difference is read before the substitution rewrites the variables..
+        const auto a = expr.vars.size() == 1 ? expr.vars.cbegin()->second : utils::rational::one; // the multipliers refer to the expression divided by its coefficient, if it has a single variable..
+        substitute_basic(expr);
+        const auto m = normalize(expr); // the scalings of the same hyperplane share the same slack variable, the negative ones reversing the inequality (i.e., `expr > 0`)..
+        const bool reversed = is_negative(m);
+        const utils::rational eps = strict ? neg(m) : utils::rational::zero; // the infinitesimal moving the right-hand side of a strict inequality inwards, scaled as the expression..
 
         switch (expr.vars.size())
         {
         case 0: // the expression is a constant..
-            return is_negative(expr.known_term) || (!strict && is_zero(expr.known_term));
+            return (reversed ? is_positive(expr.known_term) : is_negative(expr.known_term)) || (!strict && is_zero(expr.known_term));
         case 1: // the expression is a single variable..
         {
             const auto [x, c] = *expr.vars.cbegin();
             assert(c != 0);
-            const utils::inf_rational c_right = utils::inf_rational(-expr.known_term, strict ? -1 : 0) / c; // the right-hand side of the constraint is the division of the negation of the known term minus an infinitesimal by the coefficient..
-            if (is_positive(c))
-                return set_ub(x, c_right, reason); // we are in the case `c * v < c_right`..
+            const utils::inf_rational c_right = div(utils::inf_rational(neg(expr.known_term), eps), c); // the right-hand side of the constraint is the division of the negation of the known term, moved by an infinitesimal, by the coefficient..
+            const auto sc = mul(div(m, c), a); // `x` is `expr` scaled by `m / c`, up to a constant, hence so are the multipliers of its bound..
+            if (is_positive(c) != reversed)
+                return set_ub(x, c_right, reason, sc); // we are in the case `v < c_right`..
             else
-                return set_lb(x, c_right, reason); // we are in the case `c * v > c_right`..
+                return set_lb(x, c_right, reason, sc); // we are in the case `v > c_right`..
         }
         default: // the expression is still a general linear expression..
-            const utils::inf_rational c_right = utils::inf_rational(-expr.known_term, strict ? -1 : 0);
+            const utils::inf_rational c_right = utils::inf_rational(neg(expr.known_term), eps);
             expr.known_term = utils::rational::zero;
-            // we add the expression to the tableau, associating it with a new (slack) variable
-            utils::var slack = new_var(std::move(expr));
-            return set_ub(slack, c_right, reason); // we are in the case `expr < c_right`..
+            // we add the expression to the tableau, associating it with a new (slack) variable, which is also an edge of the difference graph, scaled as its expression, if it defines a difference..
+            utils::var slack = new_slack(std::move(expr), diff ? std::optional<difference>(scale(*diff, m)) : std::nullopt);
+            const auto sc = mul(m, a);
+            return reversed ? set_lb(slack, c_right, reason, sc) : set_ub(slack, c_right, reason, sc); // we are in the case `expr > c_right` or `expr < c_right`..
         }
     }
     bool solver::new_gt(const utils::lin &lhs, const utils::lin &rhs, bool strict, std::optional<std::reference_wrapper<constraint>> reason) noexcept { return new_lt(rhs, lhs, strict, reason); }
 
     bool solver::add_constraint(const constraint &c) noexcept
     {
+        const overflow_scope scope(a_overflow);
         struct staged_bounds
         {
             utils::inf_rational lb;
@@ -155,6 +267,12 @@ namespace linspire
             return inserted_it->second;
         };
 
+        // the slack variables bounded by the constraint get their rows back, so that their implied bounds are taken into account..
+        for (const auto *bs : {&c.lbs, &c.ubs})
+            for (const auto &[x, v] : *bs)
+                if (slacks[x] == slack_state::inactive)
+                    reactivate(x);
+
         for (const auto &[x, lb_val] : c.lbs)
         {
             auto &entry = ensure_entry(x);
@@ -174,292 +292,2880 @@ namespace linspire
         }
 
         for (const auto &[x, lb_val] : c.lbs)
+        {
+            trail_bound(x, false, lb_val, &c);
             vars[x].set_lb(lb_val, c);
+            invalidate_implied_bounds(x);
+        }
         for (const auto &[x, ub_val] : c.ubs)
+        {
+            trail_bound(x, true, ub_val, &c);
             vars[x].set_ub(ub_val, c);
+            invalidate_implied_bounds(x);
+        }
+
+        // we bring the non-basic variables back within their bounds and keep track of the violated basic variables..
+        for (const auto &[x, entry] : staged)
+            if (is_basic(x))
+                update_violation(x);
+            else if (val(x) < entry.lb)
+                move_to_bound(x, entry.lb);
+            else if (val(x) > entry.ub)
+                move_to_bound(x, entry.ub);
         return true;
     }
 
     void solver::retract(const constraint &c) noexcept
     {
+        const overflow_scope scope(a_overflow);
         for (const auto &[x, lb] : c.lbs)
+        {
             vars[x].unset_lb(lb, c);
+            invalidate_implied_bounds(x);
+            update_violation(x);
+        }
         for (const auto &[x, ub] : c.ubs)
+        {
             vars[x].unset_ub(ub, c);
+            invalidate_implied_bounds(x);
+            update_violation(x);
+        }
+        // the slack variables left unbounded no longer need their rows..
+        for (const auto &[x, lb] : c.lbs)
+            deactivate(x);
+        for (const auto &[x, ub] : c.ubs)
+            deactivate(x);
     }
 
-    bool solver::check() noexcept
+    void solver::push() noexcept { levels.push_back(trail.size()); }
+
+    void solver::pop(const std::size_t n) noexcept
     {
-        while (true)
-        {
-            // we search for a variable whose value is not within its bounds..
-            const auto &x_i_it = std::find_if(tableau.cbegin(), tableau.cend(), [this](const auto &v)
-                                              { return val(v.first) < lb(v.first) || val(v.first) > ub(v.first); });
-            if (x_i_it == tableau.cend())
-                return true;                // all the variables are within their bounds..
-            const auto x_i = x_i_it->first; // we select the variable `x_i`..
-            const auto &l = x_i_it->second; // we select the linear expression `x_i = ...`..
-            if (val(x_i) < lb(x_i))
-            { // the value of `x_i` is below its lower bound..
-                const auto &x_j_it = std::find_if(l.vars.cbegin(), l.vars.cend(), [l, this](const std::pair<utils::var, utils::rational> &v)
-                                                  { return (is_positive(l.vars.at(v.first)) && val(v.first) < ub(v.first)) || (is_negative(l.vars.at(v.first)) && val(v.first) > lb(v.first)); });
-                if (x_j_it != l.vars.cend()) // var x_j can be used to increase the value of x_i..
-                    pivot_and_update(x_i, x_j_it->first, lb(x_i));
-                else // no var x_j can be used to increase the value of x_i, so the constraints are inconsistent..
-                {    // we generate an explanation for the conflict..
-                    cnfl.clear();
-                    for (const auto &[v, c] : l.vars)
-                        if (is_positive(c)) // we use the most restrictive upper bound of v
-                            for (const auto &w : vars.at(v).ubs.begin()->second)
-                                cnfl.push_back(*w);
-                        else if (is_negative(c)) // we use the most restrictive lower bound of v
-                            for (const auto &w : vars.at(v).lbs.rbegin()->second)
-                                cnfl.push_back(*w);
-                    for (const auto &w : vars.at(x_i).lbs.rbegin()->second) // we use the most restrictive lower bound of x_i
-                        cnfl.push_back(*w);
-                    return false;
-                }
-            }
-            else if (val(x_i) > ub(x_i))
-            { // the value of `x_i` is above its upper bound..
-                const auto &x_j_it = std::find_if(l.vars.cbegin(), l.vars.cend(), [l, this](const std::pair<utils::var, utils::rational> &v)
-                                                  { return (is_positive(l.vars.at(v.first)) && val(v.first) > lb(v.first)) || (is_negative(l.vars.at(v.first)) && val(v.first) < ub(v.first)); });
-                if (x_j_it != l.vars.cend()) // var x_j can be used to decrease the value of x_i..
-                    pivot_and_update(x_i, x_j_it->first, ub(x_i));
-                else // no var x_j can be used to decrease the value of x_i, so the constraints are inconsistent..
-                {    // we generate an explanation for the conflict..
-                    cnfl.clear();
-                    for (const auto &[v, c] : l.vars)
-                        if (is_positive(c)) // we use the most restrictive lower bound of v
-                            for (const auto &w : vars.at(v).lbs.rbegin()->second)
-                                cnfl.push_back(*w);
-                        else if (is_negative(c)) // we use the most restrictive upper bound of v
-                            for (const auto &w : vars.at(v).ubs.begin()->second)
-                                cnfl.push_back(*w);
-                    for (const auto &w : vars.at(x_i).ubs.begin()->second) // we use the most restrictive upper bound of x_i
-                        cnfl.push_back(*w);
-                    return false;
-                }
-            }
+        const overflow_scope scope(a_overflow);
+        assert(n <= levels.size());
+        if (n == 0)
+            return;
+        const auto size = levels[levels.size() - n];
+        levels.resize(levels.size() - n);
+        while (trail.size() > size)
+        { // we undo the changes in reverse chronological order..
+            undo(trail.back());
+            trail.pop_back();
         }
     }
 
-    bool solver::match(const utils::lin &l0, const utils::lin &l1) const noexcept { return lb(l0) <= ub(l1) && ub(l0) >= lb(l1); }
-
-    bool solver::set_lb(const utils::var x, const utils::inf_rational &v, std::optional<std::reference_wrapper<constraint>> reason) noexcept
+    void solver::trail_bound(const utils::var x, const bool upper, const utils::inf_rational &v, const constraint *reason, const bool reason_updated, std::optional<utils::inf_rational> reason_prev, const utils::rational &scale_prev) noexcept
     {
-        assert(x < vars.size());
-        assert(v > utils::rational::negative_infinite);
-        LOG_TRACE("x" << std::to_string(x) << " = " << utils::to_string(val(x)) << " [" << utils::to_string(lb(x)) << " -> " << utils::to_string(v) << ", " << utils::to_string(ub(x)) << "]");
-        if (v > ub(x))
-        { // inconsistent bound..
-            cnfl.clear();
-            if (reason)
-                cnfl.push_back(reason.value());
-            for (const auto &w : vars.at(x).ubs.begin()->second) // we use the most restrictive upper bound of x
-                cnfl.push_back(*w);
-            return false;
-        }
+        if (levels.empty())
+            return; // there is nothing to backtrack to..
+        auto &e = trail.emplace_back();
+        e.k = trail_entry::kind::bound;
+        e.x = x;
+        e.upper = upper;
+        e.v = v;
+        e.reason = reason;
         if (reason)
-        { // we have a reason for this bound..
-            if (auto it = reason->get().lbs.find(x); it != reason->get().lbs.end())
-            { // we already have a lower bound for this variable in the reason..
-                if (it->second < v)
-                { // we update the lower bound only if the new one is more restrictive..
-                    vars.at(x).unset_lb(it->second, *reason);
-                    it->second = v;
-                }
-            }
-            else
-                reason->get().lbs.emplace(x, v);
+        {
+            e.reason_added = !vars[x].has_reason(upper, v, *reason);
+            e.reason_updated = reason_updated;
+            e.reason_prev = std::move(reason_prev);
+            e.scale_prev = scale_prev;
         }
-        vars.at(x).set_lb(v, reason);
-        if (val(x) < v && !is_basic(x))
-            update(x, v);
-        return true;
+        else // a bound without reason replaces all the less restrictive bounds, which we save for restoring them..
+            for (const auto &b : upper ? vars[x].ubs : vars[x].lbs)
+                if (upper ? b.v >= v : b.v <= v)
+                    e.erased.push_back(b);
     }
-    bool solver::set_ub(const utils::var x, const utils::inf_rational &v, std::optional<std::reference_wrapper<constraint>> reason) noexcept
+
+    void solver::undo(trail_entry &e) noexcept
     {
-        assert(x < vars.size());
-        assert(v < utils::rational::positive_infinite);
-        LOG_TRACE("x" << std::to_string(x) << " = " << utils::to_string(val(x)) << " [" << utils::to_string(lb(x)) << ", " << utils::to_string(v) << " <- " << utils::to_string(ub(x)) << "]");
-        if (v < lb(x))
-        { // inconsistent bound..
-            cnfl.clear();
-            if (reason)
-                cnfl.push_back(reason.value());
-            for (const auto &w : vars.at(x).lbs.rbegin()->second) // we use the most restrictive lower bound of x
-                cnfl.push_back(*w);
-            return false;
-        }
-        if (reason)
-        { // we have a reason for this bound..
-            if (auto it = reason->get().ubs.find(x); it != reason->get().ubs.end())
-            { // we already have an upper bound for this variable in the reason..
-                if (it->second > v)
-                { // we update the upper bound only if the new one is more restrictive..
-                    vars.at(x).unset_ub(it->second, *reason);
-                    it->second = v;
+        const auto x = e.x;
+        switch (e.k)
+        {
+        case trail_entry::kind::bound:
+        {
+            if (e.reason)
+            {
+                // the bound might have been retracted in the meanwhile, in which case we leave the bounds of the variable untouched..
+                const bool active = vars[x].has_reason(e.upper, e.v, *e.reason);
+                if (active && e.reason_added)
+                    e.upper ? vars[x].unset_ub(e.v, *e.reason) : vars[x].unset_lb(e.v, *e.reason);
+                if (e.reason_updated)
+                { // we restore the bound stored in the reason, which was mutable when the bound was set..
+                    auto &r = *const_cast<constraint *>(e.reason);
+                    auto &r_bounds = e.upper ? r.ubs : r.lbs;
+                    r.set_scale(x, e.upper, e.scale_prev);
+                    if (e.reason_prev)
+                    {
+                        r_bounds[x] = *e.reason_prev;
+                        if (active)
+                            e.upper ? vars[x].set_ub(*e.reason_prev, *e.reason) : vars[x].set_lb(*e.reason_prev, *e.reason);
+                    }
+                    else
+                        r_bounds.erase(x);
                 }
             }
             else
-                reason->get().ubs.emplace(x, v);
+                vars[x].restore_bounds(e.upper, e.v, e.erased);
+            invalidate_implied_bounds(x);
+            update_violation(x);
+            break;
+        }
+        case trail_entry::kind::slack:
+        {
+            if (e.reactivated)
+            { // the slack variable existed before, hence we just deactivate it again..
+                i_rows[x] = remove_slack_row(x);
+                slacks[x] = slack_state::inactive;
+                break;
+            }
+            if (slacks[x] == slack_state::difference)
+            { // the slack variable has no row, just its edges..
+                remove_difference(x);
+                --n_d_rowless;
+            }
+            else
+                remove_slack_row(x);
+            exprs.write().erase(e.expr);
+            slacks[x] = slack_state::none;
+#ifdef LINSPIRE_ENABLE_LISTENERS
+            if (x < listening.size() && !listening[x].ls.empty())
+                break; // the listeners refer to `x`, which is kept as a plain variable..
+#endif
+            if (x == vars.size() - 1)
+            { // we release the slack variable..
+                vars.pop_back();
+                slacks.pop_back();
+                tableau.write().pop_var();
+                r_bounds.pop_back();
+                if (d_vars.size() > vars.size()) // the released slack variable is no longer in the graph..
+                    d_vars.pop_back();
+            }
+            else
+            { // the variables created after it are still alive, hence its identifier is reused by the next variables..
+                vars[x] = var();
+                r_bounds[x] = implied_bounds_cache();
+                touch(x);
+                free_vars.push_back(x);
+            }
+            break;
+        }
         }
-        vars.at(x).set_ub(v, reason);
-        if (val(x) > v && !is_basic(x))
-            update(x, v);
-        return true;
     }
 
-    void solver::update(const utils::var x_i, const utils::inf_rational &v) noexcept
+    utils::lin solver::remove_slack_row(const utils::var x) noexcept
     {
-        assert(x_i < vars.size());
-        assert(!is_basic(x_i));
-        assert(v >= lb(x_i) && v <= ub(x_i));
+        if (!is_basic(x))
+        { // we bring the slack variable back into the basis, through the shortest row containing it..
+            assert(!tableau->column(x).empty());
+            auto x_k = tableau->basic(tableau->column(x).front());
+            for (const auto &o : tableau->column(x))
+                if (tableau->terms(tableau->basic(o)).size() < tableau->terms(x_k).size())
+                    x_k = tableau->basic(o);
+            pivot(x_k, x);
+            // `x_k` is now non-basic, hence we keep it within its bounds..
+            if (val(x_k) < vars[x_k].get_lb())
+                update(x_k, vars[x_k].get_lb());
+            else if (val(x_k) > vars[x_k].get_ub())
+                update(x_k, vars[x_k].get_ub());
+        }
+        // the rows kept for the inactive slack variables must not refer to `x` anymore..
+        for (auto &[y, l] : i_rows)
+            if (l.vars.count(x))
+                substitute_basic(l);
+        auto l = tableau->to_lin(x);
+        LOG_TRACE("x" << std::to_string(x) << " = " << utils::to_string(l) << " removed");
+        tableau.write().remove_row(x);
+        remove_difference(x);
+        touch(x); // `x` is no longer bounded by its row..
+        violated.erase(x);
+        return l;
+    }
 
-        // the tableau rows containing `x_i` as a non-basic variable..
-        for (const auto &x_j : t_watches[x_i])
-        { // x_j = x_j + a_ji(v - x_i)..
-            LOG_TRACE("x" << std::to_string(x_j) << " = " << utils::to_string(val(x_j)) << " -> " << utils::to_string(val(x_j) + tableau.at(x_j).vars.at(x_i) * (v - vars.at(x_i).val)) << " [" << utils::to_string(lb(x_j)) << ", " << utils::to_string(ub(x_j)) << "]");
-            vars[x_j].val += tableau.at(x_j).vars.at(x_i) * (v - vars.at(x_i).val);
-            FIRE_ON_VALUE_CHANGED(x_j);
+    void solver::deactivate(const utils::var x) noexcept
+    {
+        if (!levels.empty() || (slacks[x] != slack_state::active && slacks[x] != slack_state::difference) || !vars[x].lbs.empty() || !vars[x].ubs.empty())
+            return;
+        if (x < d_vars.size() && d_vars[x].r == difference_var::role::vertex)
+            return; // the edges of other differences refer to `x`..
+#ifdef LINSPIRE_ENABLE_LISTENERS
+        if (x < listening.size() && !listening[x].ls.empty())
+            return; // the listeners expect the value of `x` to be kept up to date..
+#endif
+        if (slacks[x] == slack_state::difference)
+        { // the slack variable has no row, hence we keep aside its difference..
+            auto l = to_lin(d_vars[x].d);
+            substitute_basic(l);
+            i_rows[x] = std::move(l);
+            remove_difference(x);
+            --n_d_rowless;
         }
+        else
+            i_rows[x] = remove_slack_row(x);
+        slacks[x] = slack_state::inactive;
+    }
 
-        LOG_TRACE("x" << std::to_string(x_i) << " = " << utils::to_string(val(x_i)) << " -> " << utils::to_string(v) << " [" << utils::to_string(lb(x_i)) << ", " << utils::to_string(ub(x_i)) << "]");
-        vars[x_i].val = v;
-        FIRE_ON_VALUE_CHANGED(x_i);
+    void solver::reactivate(const utils::var x) noexcept
+    {
+        assert(slacks[x] == slack_state::inactive);
+        add_difference_rows(); // the row of `x` is not known to define a difference..
+        const auto it = i_rows.find(x);
+        assert(it != i_rows.end());
+        auto l = std::move(it->second);
+        i_rows.erase(it);
+        substitute_basic(l); // the basis might have changed since the deactivation..
+        vars[x].val = val(l);
+        touch(x);
+        slacks[x] = slack_state::active;
+        if (!levels.empty())
+        { // we record the reactivation, so that it can be undone when backtracking..
+            auto &e = trail.emplace_back();
+            e.k = trail_entry::kind::slack;
+            e.x = x;
+            e.reactivated = true;
+        }
+        new_row(x, std::move(l));
     }
 
-    void solver::pivot_and_update(const utils::var x_i, const utils::var x_j, const utils::inf_rational &v) noexcept
+    std::size_t solver::gc() noexcept
     {
-        assert(x_i < vars.size());
-        assert(x_j < vars.size());
-        assert(is_basic(x_i));
-        assert(!is_basic(x_j));
-        assert(tableau.at(x_i).vars.count(x_j));
-        assert(v >= lb(x_i) && v <= ub(x_i));
+        if (!levels.empty() || batching)
+            return 0; // the trail, or the pending variables, might refer to the slack variables..
+        for (utils::var x = 0; x < vars.size(); ++x)
+            deactivate(x);
 
-        const auto theta = (v - val(x_i)) / tableau.at(x_i).vars.at(x_j);
-        LOG_TRACE("x" << std::to_string(x_i) << " = " << utils::to_string(val(x_i)) << " -> " << utils::to_string(v) << " [" << utils::to_string(lb(x_i)) << ", " << utils::to_string(ub(x_i)) << "]");
-        // x_i = v
-        vars[x_i].val = v;
-        FIRE_ON_VALUE_CHANGED(x_i);
-        LOG_TRACE("x" << std::to_string(x_j) << " = " << utils::to_string(val(x_j)) << " -> " << utils::to_string(val(x_j) + theta) << " [" << utils::to_string(lb(x_j)) << ", " << utils::to_string(ub(x_j)) << "]");
-        // x_j += theta
-        vars[x_j].val += theta;
-        assert(vars[x_j].val >= lb(x_j) && vars[x_j].val <= ub(x_j));
-        FIRE_ON_VALUE_CHANGED(x_j);
+        // we count the expressions each variable appears in, and collect the expressions of the inactive slack variables..
+        std::vector<std::size_t> refs(vars.size(), 0);
+        std::vector<std::pair<utils::var, utils::lin>> dead;
+        exprs->for_each([this, &refs, &dead](const auto &terms, const utils::rational &known_term, const utils::var slack)
+                       {
+                           for (const auto &[v, c] : terms)
+                               ++refs[v];
+                           if (slacks[slack] == slack_state::inactive)
+                           {
+                               auto &l = dead.emplace_back(slack, utils::lin(known_term)).second;
+                               for (const auto &[v, c] : terms)
+                                   l.vars.emplace_hint(l.vars.cend(), v, c);
+                           } });
 
-        // the tableau rows containing `x_j` as a non-basic variable..
-        for (const auto &x_k : t_watches[x_j])
-            if (x_k != x_i)
-            { // x_k += a_kj * theta..
-                LOG_TRACE("x" << std::to_string(x_k) << " = " << utils::to_string(val(x_k)) << " -> " << utils::to_string(val(x_k) + tableau.at(x_k).vars.at(x_j) * theta) << " [" << utils::to_string(lb(x_k)) << ", " << utils::to_string(ub(x_k)) << "]");
-                vars[x_k].val += tableau.at(x_k).vars.at(x_j) * theta;
-                FIRE_ON_VALUE_CHANGED(x_k);
+        // we release the inactive slack variables which appear in no expression, until no more can be released..
+        std::size_t n = 0;
+        for (bool changed = true; changed;)
+        {
+            changed = false;
+            for (const auto &[x, l] : dead)
+            {
+                if (slacks[x] != slack_state::inactive || refs[x])
+                    continue;
+#ifdef LINSPIRE_ENABLE_LISTENERS
+                if (x < listening.size() && !listening[x].ls.empty())
+                    continue;
+#endif
+                exprs.write().erase(l);
+                for (const auto &[v, c] : l.vars)
+                    --refs[v];
+                i_rows.erase(x);
+                slacks[x] = slack_state::none;
+                vars[x] = var();
+                r_bounds[x] = implied_bounds_cache();
+                touch(x);
+                free_vars.push_back(x);
+                changed = true;
+                ++n;
             }
+        }
 
-        pivot(x_i, x_j);
+        // we release the released variables which appear in no expression and in no row..
+        for (const auto &[x, l] : i_rows)
+            for (const auto &[v, c] : l.vars)
+                ++refs[v];
+        for (utils::var x = 0; x < vars.size(); ++x)
+            if (slacks[x] == slack_state::released && !refs[x] && !is_basic(x) && tableau->column(x).empty())
+            {
+                remove_difference(x);
+                slacks[x] = slack_state::none;
+                vars[x] = var();
+                r_bounds[x] = implied_bounds_cache();
+                touch(x);
+                free_vars.push_back(x);
+                ++n;
+            }
+
+        // the trailing identifiers are dropped, so that the per-variable vectors shrink, the others are reused by the next variables..
+        std::sort(free_vars.begin(), free_vars.end());
+        while (!free_vars.empty() && free_vars.back() == vars.size() - 1)
+        {
+            free_vars.pop_back();
+            vars.pop_back();
+            slacks.pop_back();
+            tableau.write().pop_var();
+            r_bounds.pop_back();
+        }
+        if (d_vars.size() > vars.size()) // the released variables are no longer in the graph..
+            d_vars.resize(vars.size());
+        return n;
     }
 
-    void solver::pivot(const utils::var x_i, const utils::var x_j) noexcept
+    bool solver::release(const utils::var x) noexcept
     {
-        assert(x_i < vars.size());
-        assert(x_j < vars.size());
-        assert(is_basic(x_i));
-        assert(!is_basic(x_j));
-        assert(tableau.at(x_i).vars.count(x_j));
-        assert(t_watches.at(x_i).empty());
-
-        // we remove the row from the watches
-        for ([[maybe_unused]] const auto &[v, c] : tableau[x_i].vars)
-        {
-            assert(t_watches.at(v).count(x_i));
-            t_watches.at(v).erase(x_i);
+        assert(x < vars.size());
+        if (!levels.empty() || batching || (slacks[x] != slack_state::none && slacks[x] != slack_state::pinned))
+            return false; // the slack variables created by the constraints are reclaimed by `gc`..
+        for (const auto *bs : {&vars[x].lbs, &vars[x].ubs})
+            for (const auto &b : *bs)
+                if (b.reason)
+                    return false; // the constraints bounding `x` have to be retracted first..
+#ifdef LINSPIRE_ENABLE_LISTENERS
+        if (x < listening.size() && !listening[x].ls.empty())
+            return false;
+#endif
+        if (slacks[x] == slack_state::pinned)
+        { // the slack variable loses its row, and its expression..
+            std::optional<utils::lin> expr;
+            exprs->for_each([x, &expr](const auto &terms, const utils::rational &known_term, const utils::var slack)
+                           {
+                               if (slack != x)
+                                   return;
+                               expr.emplace(known_term);
+                               for (const auto &[v, c] : terms)
+                                   expr->vars.emplace_hint(expr->vars.cend(), v, c); });
+            remove_slack_row(x);
+            if (expr)
+                exprs.write().erase(*expr);
+        }
+        else if (is_basic(x))
+        { // we pivot `x` out of the basis, through the variable of its row appearing in the fewest rows..
+            const auto &terms = tableau->terms(x);
+            if (terms.empty())
+            {
+                tableau.write().remove_row(x);
+                violated.erase(x);
+            }
+            else
+            {
+                auto x_j = terms.front().v;
+                for (const auto &t : terms)
+                    if (tableau->column(t.v).size() < tableau->column(x_j).size())
+                        x_j = t.v;
+                pivot(x, x_j);
+            }
         }
 
-        // we rewrite `x_i = ...` as `x_j = ...`
-        utils::lin l = std::move(tableau.at(x_i));
-        utils::rational cc = l.vars.at(x_j);
-        l.vars.erase(x_j);
-        l /= -cc;
-        l.vars.emplace(x_i, utils::rational::one / cc);
-        tableau.erase(x_i);
+        // `x` is now non-basic, and is fixed at its current value..
+        const auto v = vars[x].val;
+        vars[x] = var();
+        vars[x].val = v;
+        vars[x].set_lb(v);
+        vars[x].set_ub(v);
+        slacks[x] = slack_state::released;
+        invalidate_implied_bounds(x);
+        return true;
+    }
+
+    std::optional<std::vector<utils::var>> solver::renumber(const std::vector<std::reference_wrapper<constraint>> &cs) noexcept
+    {
+        if (!levels.empty() || batching)
+            return std::nullopt;
+        std::unordered_map<const constraint *, std::size_t> known;
+        for (std::size_t i = 0; i < cs.size(); ++i)
+            known.emplace(&cs[i].get(), i);
+        for (const auto &x : vars)
+            for (const auto *bs : {&x.lbs, &x.ubs})
+                for (const auto &b : *bs)
+                    if (b.reason && !known.count(b.reason))
+                        return std::nullopt;
 
-        // we update the rows that contain `x_j`
-        for (auto &r : t_watches.at(x_j))
+        // the live variables keep their relative order, hence the terms of the expressions stay sorted..
+        std::vector<utils::var> remap(vars.size(), npos);
+        std::vector<bool> dead(vars.size(), false);
+        for (const auto x : free_vars)
+            dead[x] = true;
+        utils::var n = 0;
+        for (utils::var x = 0; x < vars.size(); ++x)
+            if (!dead[x])
+                remap[x] = n++;
+        if (n == vars.size())
+            return remap; // there is nothing to compact..
+        const auto remap_lin = [&remap](const utils::lin &l)
         {
-            auto &c_l = tableau.at(r);
-            assert(c_l.known_term == utils::rational::zero);
-            cc = c_l.vars.at(x_j);
-            c_l.vars.erase(x_j);
+            utils::lin r(l.known_term);
             for (const auto &[v, c] : l.vars)
-                if (const auto trm_it = c_l.vars.find(v); trm_it == c_l.vars.cend()) // `v` is not in the linear expression of `r`, so we add it
-                {
-                    c_l.vars.emplace(v, c * cc); // we add `c * cc` to the linear expression of `r`
-                    t_watches[v].insert(r);      // we add `r` to the watches of `v`
-                }
-                else
+            {
+                assert(remap[v] != npos);
+                r.vars.emplace_hint(r.vars.cend(), remap[v], c);
+            }
+            return r;
+        };
+
+        // the variables, with their states and their rows..
+        std::vector<var> n_vars;
+        std::vector<slack_state> n_slacks;
+        n_vars.reserve(n);
+        n_slacks.reserve(n);
+        flat_tableau n_tableau;
+        for (utils::var x = 0; x < vars.size(); ++x)
+            if (remap[x] != npos)
+            {
+                n_vars.push_back(std::move(vars[x]));
+                n_slacks.push_back(slacks[x]);
+                n_tableau.add_var();
+            }
+        for (const auto &r : tableau->rows())
+            n_tableau.add_row(remap[r.basic], remap_lin(tableau->to_lin(r.basic)));
+
+        // the expressions, with the rows of the inactive slack variables..
+        expr_table n_exprs;
+        exprs->for_each([&remap, &n_exprs](const auto &terms, const utils::rational &known_term, const utils::var slack)
+                       {
+                           utils::lin l(known_term);
+                           for (const auto &[v, c] : terms)
+                               l.vars.emplace_hint(l.vars.cend(), remap[v], c);
+                           n_exprs.insert(l, remap[slack]); });
+        std::unordered_map<utils::var, utils::lin> n_i_rows;
+        for (const auto &[x, l] : i_rows)
+            n_i_rows.emplace(remap[x], remap_lin(l));
+        var_set n_violated;
+        for (const auto x : violated)
+            n_violated.insert(n_violated.end(), remap[x]);
+        for (auto &b : i_bounds)
+            b.x = remap[b.x];
+
+        // the bounds stored in the constraints..
+        for (const auto &c : cs)
+        {
+            for (auto *bs : {&c.get().lbs, &c.get().ubs})
+            {
+                std::decay_t<decltype(*bs)> n_bs;
+                for (const auto &[x, v] : *bs)
+                    if (x < remap.size() && remap[x] != npos)
+                        n_bs.emplace_hint(n_bs.cend(), remap[x], v);
+                *bs = std::move(n_bs);
+            }
+            for (auto *ss : {&c.get().l_scales, &c.get().u_scales})
+            {
+                std::decay_t<decltype(*ss)> n_ss;
+                for (const auto &[x, sc] : *ss)
+                    if (x < remap.size() && remap[x] != npos)
+                        n_ss.emplace_hint(n_ss.cend(), remap[x], sc);
+                *ss = std::move(n_ss);
+            }
+        }
+
+#ifdef LINSPIRE_ENABLE_LISTENERS
+        std::vector<var_listeners> n_listening(std::min<std::size_t>(n, listening.size()));
+        for (utils::var x = 0; x < listening.size(); ++x)
+            if (remap[x] != npos && remap[x] < n_listening.size())
+                n_listening[remap[x]] = std::move(listening[x]);
+        listening = std::move(n_listening);
+        for (auto *l : listeners)
+        {
+            for (auto &x : l->listened_vars)
+                x = remap[x];
+            for (auto &x : l->changed)
+                x = remap[x];
+        }
+        for (auto &x : dirty)
+            x = remap[x];
+#endif
+
+        std::vector<difference_var> n_d_vars(std::min<std::size_t>(n, d_vars.size()));
+        for (utils::var x = 0; x < d_vars.size(); ++x)
+            if (remap[x] != npos && remap[x] < n_d_vars.size())
+            {
+                auto &dv = n_d_vars[remap[x]] = d_vars[x];
+                if (dv.r == difference_var::role::difference)
                 {
-                    trm_it->second += c * cc;
-                    if (trm_it->second == 0) // if the coefficient of `v` is zero, we remove the term from the linear expression
-                    {
-                        c_l.vars.erase(trm_it); // we remove `v` from the linear expression of `r`
-                        t_watches[v].erase(r);  // we remove `r` from the watches of `v`
-                    }
+                    dv.d.x = remap[dv.d.x];
+                    dv.d.y = remap[dv.d.y];
                 }
-            LOG_TRACE("x" << std::to_string(r) << " = " << to_string(c_l));
-        }
-        t_watches.at(x_j).clear();
+            }
 
-        // we add the new row `y = ...`
-        new_row(x_j, std::move(l));
+        vars = std::move(n_vars);
+        slacks = std::move(n_slacks);
+        free_vars = std::vector<utils::var>();
+        tableau.assign(std::move(n_tableau));
+        r_bounds = std::vector<implied_bounds_cache>(n);
+        exprs.assign(std::move(n_exprs));
+        i_rows = std::move(n_i_rows);
+        violated = std::move(n_violated);
+        s_chunks.clear();
+        s_dirty.clear();
+        // the difference graph is rebuilt on the new identifiers..
+        d_graph = difference_graph();
+        d_vars = std::move(n_d_vars);
+        n_d_slacks = 0;
+        for (utils::var x = 0; x < d_vars.size(); ++x)
+            if (d_vars[x].r != difference_var::role::none)
+                add_difference_edges(x);
+        return remap;
     }
 
-    void solver::new_row(const utils::var x, utils::lin &&l) noexcept
+    void solver::begin_batch() noexcept { batching = true; }
+
+    void solver::commit() noexcept
     {
-        assert(x < vars.size());
-        assert(!is_basic(x));
-        LOG_TRACE("x" << std::to_string(x) << " = " << utils::to_string(l));
-        for (const auto &[v, _] : l.vars)
-            t_watches.at(v).insert(x);
-        tableau.emplace(x, std::move(l));
+        const overflow_scope scope(a_overflow);
+        if (!batching)
+            return;
+        batching = false;
+        bool changed = false;
+        for (const auto &x : pending)
+            if (!is_basic(x))
+            { // we bring the non-basic variable within its (final) bounds..
+                if (vars[x].val < vars[x].get_lb())
+                    vars[x].val = vars[x].get_lb();
+                else if (vars[x].val > vars[x].get_ub())
+                    vars[x].val = vars[x].get_ub();
+                else
+                    continue;
+                changed = true;
+                touch(x);
+                FIRE_ON_VALUE_CHANGED(x);
+            }
+        pending.clear();
+        if (changed) // we propagate all the changes at once..
+            recompute_basic_values();
     }
 
-    std::string to_string(const solver &s) noexcept
+    void solver::compact() noexcept
     {
-        std::string str;
-        for (utils::var i = 0; i < s.vars.size(); ++i)
-            str += "x" + std::to_string(i) + " = " + to_string(s.vars.at(i)) + "\n";
-        for (const auto &[v, expr] : s.tableau)
-            str += "x" + std::to_string(v) + " = " + utils::to_string(expr) + "\n";
-        return str;
+        if (!tableau.shared()) // a private copy of a shared tableau would just take more memory..
+            tableau.write().compact();
+        d_graph.compact();
+        vars.shrink_to_fit();
+        slacks.shrink_to_fit();
+        free_vars.shrink_to_fit();
+        d_vars.shrink_to_fit();
+        r_bounds.shrink_to_fit();
+        trail.shrink_to_fit();
+        levels.shrink_to_fit();
+        pending.shrink_to_fit();
+        cnfl.shrink_to_fit();
     }
 
-    json::json to_json(const solver &s) noexcept
+    /**
+     * @brief Returns the estimated number of bytes allocated by the nodes of the node-based (tree) container `c`.
+     */
+    template <typename C>
+    static std::size_t tree_bytes(const C &c) noexcept { return c.size() * (sizeof(typename C::value_type) + 4 * sizeof(void *)); }
+    /**
+     * @brief Returns the estimated number of bytes allocated by the buckets and the nodes of the hash table `c`.
+     */
+    template <typename C>
+    static std::size_t hash_bytes(const C &c) noexcept { return c.bucket_count() * sizeof(void *) + c.size() * (sizeof(typename C::value_type) + 2 * sizeof(void *)); }
+
+    memory_report solver::memory_usage() const noexcept
     {
-        json::json j;
-        json::json j_vars;
-        for (utils::var i = 0; i < s.vars.size(); ++i)
-            j_vars["x" + std::to_string(i)] = to_json(s.vars.at(i));
-        j["vars"] = j_vars;
-        json::json j_tableau;
-        for (const auto &[v, expr] : s.tableau)
-            j_tableau["x" + std::to_string(v)] = to_json(expr);
-        j["tableau"] = j_tableau;
-        return j;
-    }
+        memory_report r;
+        r.vars = vars.capacity() * sizeof(var) + slacks.capacity() * sizeof(slack_state) + free_vars.capacity() * sizeof(utils::var);
+        for (const auto &x : vars)
+            r.vars += (x.lbs.capacity() + x.ubs.capacity()) * sizeof(var::bound);
 
-    json::json to_json(const utils::rational &r) noexcept { return json::json{{"num", r.numerator()}, {"den", r.denominator()}}; }
+        // the structures shared with clones are accounted apart, since they are not copied..
+        (tableau.shared() ? r.shared : r.tableau) += tableau->memory_usage();
+        r.tableau += r_bounds.capacity() * sizeof(implied_bounds_cache);
+        for (const auto &rw : tableau->rows())
+        {
+            std::size_t i = 0;
+            for (auto n = rw.terms.size(); n > 1; n >>= 1)
+                ++i;
+            if (i >= r.row_density.size())
+                r.row_density.resize(i + 1);
+            ++r.row_density[i];
+        }
 
-    json::json to_json(const utils::inf_rational &r) noexcept
+        (exprs.shared() ? r.shared : r.exprs) += exprs->memory_usage();
+        r.exprs += hash_bytes(i_rows);
+        for (const auto &[x, l] : i_rows)
+            r.exprs += tree_bytes(l.vars);
+
+        r.trail = trail.capacity() * sizeof(trail_entry) + levels.capacity() * sizeof(std::size_t);
+        for (const auto &e : trail)
+            r.trail += e.erased.capacity() * sizeof(var::bound) + tree_bytes(e.expr.vars);
+
+        r.conflicts = cnfl.capacity() * sizeof(std::reference_wrapper<const constraint>) + cnfl_coeffs.capacity() * sizeof(utils::rational) + hash_bytes(cnfl_idx) + i_bounds.capacity() * sizeof(implied_bound);
+        for (const auto &b : i_bounds)
+            r.conflicts += b.reasons.capacity() * sizeof(std::reference_wrapper<const constraint>);
+
+        r.differences = d_graph.memory_usage() + d_vars.capacity() * sizeof(difference_var);
+
+#ifdef LINSPIRE_ENABLE_LISTENERS
+        r.listeners = listening.capacity() * sizeof(var_listeners) + listeners.capacity() * sizeof(listener *) + dirty.capacity() * sizeof(utils::var);
+        for (const auto &vl : listening)
+            r.listeners += vl.ls.capacity() * sizeof(listener *);
+#endif
+
+        r.other = tree_bytes(violated) + pending.capacity() * sizeof(utils::var) + s_chunks.capacity() * sizeof(std::shared_ptr<const solver_snapshot::chunk>) + s_dirty.capacity() / 8;
+#ifdef LINSPIRE_ENABLE_TRACE
+        r.other += c_trace.capacity() * sizeof(trace_event);
+#endif
+        return r;
+    }
+
+    /**
+     * @brief Writes values as 64-bit words, in the native byte order.
+     */
+    class binary_writer
     {
-        json::json j = to_json(r.get_rational());
+    public:
+        explicit binary_writer(std::ostream &os) noexcept : os(os) {}
+
+        void word(const std::uint64_t w) noexcept { os.write(reinterpret_cast<const char *>(&w), sizeof(w)); }
+        void rat(const utils::rational &r) noexcept
+        { // an infinite rational has a null denominator..
+            word(static_cast<std::uint64_t>(static_cast<std::int64_t>(r.numerator())));
+            word(static_cast<std::uint64_t>(static_cast<std::int64_t>(r.denominator())));
+        }
+        void inf_rat(const utils::inf_rational &r) noexcept
+        {
+            rat(r.get_rational());
+            rat(r.get_infinitesimal());
+        }
+
+    private:
+        std::ostream &os;
+    };
+
+    /**
+     * @brief Reads the values written by a `binary_writer`, failing on truncated or malformed input.
+     */
+    class binary_reader
+    {
+    public:
+        explicit binary_reader(std::istream &is) noexcept : is(is) {}
+
+        [[nodiscard]] bool ok() const noexcept { return !failed; }
+        void fail() noexcept { failed = true; }
+
+        std::uint64_t word() noexcept
+        {
+            std::uint64_t w = 0;
+            if (!failed && !is.read(reinterpret_cast<char *>(&w), sizeof(w)))
+                failed = true;
+            return failed ? 0 : w;
+        }
+        /**
+         * @brief Reads an index, failing if it is not less than `n`.
+         */
+        std::size_t index(const std::size_t n) noexcept
+        {
+            const auto w = word();
+            if (w >= n)
+                failed = true;
+            return failed ? 0 : static_cast<std::size_t>(w);
+        }
+        utils::rational rat() noexcept
+        {
+            const auto num = static_cast<std::int64_t>(word());
+            const auto den = static_cast<std::int64_t>(word());
+            if (failed)
+                return utils::rational::zero;
+            if (den == 0 && num != 0)
+                return num > 0 ? utils::rational::positive_infinite : utils::rational::negative_infinite;
+            if (den <= 0 || num == std::numeric_limits<std::int64_t>::min())
+            {
+                failed = true;
+                return utils::rational::zero;
+            }
+            return utils::rational(num, den);
+        }
+        utils::inf_rational inf_rat() noexcept
+        {
+            const auto r = rat();
+            const auto i = rat();
+            if (is_infinite(i) || (is_infinite(r) && !is_zero(i)))
+                failed = true;
+            return failed ? utils::inf_rational(utils::rational::zero) : utils::inf_rational(r, i);
+        }
+
+    private:
+        std::istream &is;
+        bool failed = false;
+    };
+
+    static constexpr std::uint64_t save_magic = 0x3145544154534c4c; // `LLSTATE1`, in little-endian byte order..
+    static constexpr std::uint64_t save_version = 4; // version 1 lacks the states of the slack variables, version 2 the scales of the bounds of the constraints, version 3 the slack variables without a row..
+    static constexpr std::uint64_t no_reason = std::numeric_limits<std::uint64_t>::max();
+
+    bool solver::save(std::ostream &os, const std::vector<std::reference_wrapper<const constraint>> &cs) const noexcept
+    {
+        if (!levels.empty() || batching)
+            return false; // the trail refers to the state being replaced..
+        std::unordered_map<const constraint *, std::uint64_t> idx;
+        for (std::size_t i = 0; i < cs.size(); ++i)
+            idx.emplace(&cs[i].get(), i);
+        for (const auto &x : vars)
+            for (const auto *bs : {&x.lbs, &x.ubs})
+                for (const auto &b : *bs)
+                    if (b.reason && !idx.count(b.reason))
+                        return false;
+
+        binary_writer w(os);
+        w.word(save_magic);
+        w.word(save_version);
+        w.word(vars.size());
+        w.word(cs.size());
+        for (const auto &x : vars)
+        {
+            w.inf_rat(x.val);
+            for (const auto *bs : {&x.lbs, &x.ubs})
+            {
+                w.word(bs->size());
+                for (const auto &b : *bs)
+                {
+                    w.inf_rat(b.v);
+                    w.word(b.reason ? idx.at(b.reason) : no_reason);
+                }
+            }
+        }
+        // we keep the order of the rows, so that the restored solver pivots as this one would..
+        w.word(tableau->rows().size());
+        for (const auto &r : tableau->rows())
+        {
+            w.word(r.basic);
+            w.word(r.terms.size());
+            for (const auto &t : r.terms)
+            {
+                w.word(t.v);
+                w.rat(t.c);
+            }
+        }
+        w.word(exprs->size());
+        exprs->for_each([&w](const auto &terms, const utils::rational &known_term, const utils::var slack)
+                       {
+                           w.word(slack);
+                           w.rat(known_term);
+                           w.word(terms.size());
+                           for (const auto &[v, c] : terms)
+                           {
+                               w.word(v);
+                               w.rat(c);
+                           } });
+        for (const auto &c : cs)
+            for (const bool upper : {false, true})
+            {
+                const auto &bs = upper ? c.get().ubs : c.get().lbs;
+                w.word(bs.size());
+                for (const auto &[x, v] : bs)
+                {
+                    w.word(x);
+                    w.inf_rat(v);
+                    w.rat(c.get().scale(x, upper));
+                }
+            }
+        const auto n_d_vars = std::min(d_vars.size(), vars.size()); // the released slack variables are no longer in the graph..
+        w.word(n_d_vars);
+        for (std::size_t x = 0; x < n_d_vars; ++x)
+        {
+            const auto &dv = d_vars[x];
+            w.word(static_cast<std::uint64_t>(dv.r));
+            w.word(dv.d.x);
+            w.word(dv.d.y);
+            w.rat(dv.d.a);
+        }
+        for (const auto &st : slacks)
+            w.word(static_cast<std::uint64_t>(st));
+        for (utils::var x = 0; x < vars.size(); ++x)
+            if (slacks[x] == slack_state::inactive)
+            {
+                const auto &l = i_rows.at(x);
+                w.word(l.vars.size());
+                for (const auto &[v, c] : l.vars)
+                {
+                    w.word(v);
+                    w.rat(c);
+                }
+            }
+        w.word(free_vars.size());
+        for (const auto &x : free_vars)
+            w.word(x);
+        return static_cast<bool>(os);
+    }
+
+    bool solver::load(std::istream &is, const std::vector<std::reference_wrapper<constraint>> &cs) noexcept
+    {
+        if (!vars.empty() || !levels.empty() || batching)
+            return false;
+        binary_reader r(is);
+        if (r.word() != save_magic)
+            return false;
+        const auto version = r.word();
+        if (version < 1 || version > save_version)
+            return false;
+        const auto n_vars = r.word();
+        if (!r.ok() || r.word() != cs.size())
+            return false;
+
+        // we first read, and validate, the whole state, so that the solver is left untouched on failure..
+        struct saved_var
+        {
+            utils::inf_rational val;
+            std::vector<std::pair<utils::inf_rational, std::size_t>> bounds[2]; // the lower and upper bounds, with the positions of their reasons..
+        };
+        std::vector<saved_var> s_vars;
+        for (std::uint64_t x = 0; r.ok() && x < n_vars; ++x)
+        {
+            auto &sv = s_vars.emplace_back();
+            sv.val = r.inf_rat();
+            for (bool upper : {false, true})
+            {
+                const auto n = r.word();
+                for (std::uint64_t i = 0; r.ok() && i < n; ++i)
+                {
+                    const auto v = r.inf_rat();
+                    const auto reason = r.word();
+                    if (reason != no_reason && reason >= cs.size())
+                        r.fail();
+                    // the bounds are sorted from the least to the most restrictive..
+                    else if (auto &bs = sv.bounds[upper]; !bs.empty() && (upper ? bs.back().first < v : v < bs.back().first))
+                        r.fail();
+                    else
+                        bs.emplace_back(v, reason == no_reason ? std::numeric_limits<std::size_t>::max() : static_cast<std::size_t>(reason));
+                }
+            }
+            if (!sv.bounds[0].empty() && !sv.bounds[1].empty() && sv.bounds[1].back().first < sv.bounds[0].back().first)
+                r.fail();
+        }
+        if (!r.ok())
+            return false;
+
+        std::vector<bool> basic(n_vars, false);
+        std::vector<std::pair<utils::var, utils::lin>> rows;
+        for (std::uint64_t i = 0, n = r.word(); r.ok() && i < n; ++i)
+        {
+            const auto x = r.index(n_vars);
+            if (!r.ok() || basic[x])
+                return false;
+            basic[x] = true;
+            auto &[b, l] = rows.emplace_back(x, utils::lin());
+            for (std::uint64_t j = 0, n_terms = r.word(); r.ok() && j < n_terms; ++j)
+            {
+                const auto v = r.index(n_vars);
+                const auto c = r.rat();
+                if (!r.ok() || is_zero(c) || is_infinite(c) || !l.vars.emplace(v, c).second)
+                    return false;
+            }
+        }
+        if (!r.ok())
+            return false;
+        for (const auto &[x, l] : rows)
+        { // the rows are expressed in terms of non-basic variables, and agree with the saved assignment..
+            utils::inf_rational v(utils::rational::zero);
+            for (const auto &[y, c] : l.vars)
+                if (basic[y])
+                    return false;
+                else
+                    add_mul(v, c, s_vars[y].val);
+            if (v != s_vars[x].val)
+                return false;
+        }
+        for (utils::var x = 0; x < n_vars; ++x)
+            if (const auto &sv = s_vars[x]; !basic[x] && ((!sv.bounds[0].empty() && sv.val < sv.bounds[0].back().first) || (!sv.bounds[1].empty() && sv.val > sv.bounds[1].back().first)))
+                return false; // the non-basic variables are always within their bounds..
+
+        std::vector<std::pair<utils::lin, utils::var>> s_exprs;
+        for (std::uint64_t i = 0, n = r.word(); r.ok() && i < n; ++i)
+        {
+            const auto slack = r.index(n_vars);
+            auto &[l, x] = s_exprs.emplace_back(utils::lin(r.rat()), slack);
+            for (std::uint64_t j = 0, n_terms = r.word(); r.ok() && j < n_terms; ++j)
+            {
+                const auto v = r.index(n_vars);
+                const auto c = r.rat();
+                if (!r.ok() || is_zero(c) || is_infinite(c) || !l.vars.emplace(v, c).second)
+                    return false;
+            }
+        }
+
+        std::vector<std::array<std::vector<std::tuple<utils::var, utils::inf_rational, utils::rational>>, 2>> s_cs(cs.size());
+        for (auto &c : s_cs)
+            for (auto &bs : c)
+                for (std::uint64_t i = 0, n = r.word(); r.ok() && i < n; ++i)
+                {
+                    const auto x = r.index(n_vars);
+                    const auto v = r.inf_rat();
+                    const auto sc = version < 3 ? utils::rational::one : r.rat(); // the bounds were not scaled..
+                    if (r.ok() && ((!bs.empty() && std::get<0>(bs.back()) >= x) || is_zero(sc) || is_infinite(sc)))
+                        r.fail();
+                    bs.emplace_back(x, v, sc);
+                }
+
+        std::vector<difference_var> s_d_vars;
+        const auto n_d_vars = r.word();
+        if (n_d_vars > n_vars)
+            return false;
+        for (std::uint64_t x = 0; r.ok() && x < n_d_vars; ++x)
+        {
+            auto &dv = s_d_vars.emplace_back();
+            const auto role = r.word();
+            dv.d.x = r.word();
+            dv.d.y = r.word();
+            dv.d.a = r.rat();
+            if (role == static_cast<std::uint64_t>(difference_var::role::vertex))
+                dv.r = difference_var::role::vertex;
+            else if (role == static_cast<std::uint64_t>(difference_var::role::difference) && dv.d.x < x && dv.d.y < x && dv.d.x != dv.d.y && is_positive(dv.d.a) && !is_infinite(dv.d.a))
+                dv.r = difference_var::role::difference;
+            else if (role != static_cast<std::uint64_t>(difference_var::role::none))
+                r.fail();
+        }
+        for (const auto &dv : s_d_vars)
+            if (dv.r == difference_var::role::difference && (s_d_vars[dv.d.x].r != difference_var::role::vertex || s_d_vars[dv.d.y].r != difference_var::role::vertex))
+                r.fail();
+        if (!r.ok())
+            return false;
+
+        // the states of the slack variables, with the rows of the inactive ones, and the reusable identifiers..
+        std::vector<slack_state> s_slacks(n_vars, slack_state::none);
+        std::unordered_map<utils::var, utils::lin> s_i_rows;
+        std::vector<utils::var> s_free_vars;
+        if (version == 1) // all the slack variables were active..
+            for (const auto &[l, x] : s_exprs)
+                s_slacks[x] = slack_state::active;
+        else
+        {
+            for (auto &st : s_slacks)
+                if (const auto w = r.word(); w <= static_cast<std::uint64_t>(version < 4 ? slack_state::released : slack_state::difference))
+                    st = static_cast<slack_state>(w);
+                else
+                    r.fail();
+            for (utils::var x = 0; r.ok() && x < n_vars; ++x)
+                if (s_slacks[x] == slack_state::inactive)
+                { // inactive slack variables have no row and no bounds, and are defined over variables which might have become basic since, as `reactivate` substitutes them..
+                    if (basic[x] || !s_vars[x].bounds[0].empty() || !s_vars[x].bounds[1].empty())
+                        return false;
+                    auto &l = s_i_rows[x];
+                    for (std::uint64_t j = 0, n_terms = r.word(); r.ok() && j < n_terms; ++j)
+                    {
+                        const auto v = r.index(n_vars);
+                        const auto c = r.rat();
+                        if (!r.ok() || v == x || is_zero(c) || is_infinite(c) || !l.vars.emplace(v, c).second)
+                            return false;
+                    }
+                }
+                else if (s_slacks[x] == slack_state::difference && (basic[x] || x >= s_d_vars.size() || s_d_vars[x].r != difference_var::role::difference))
+                    return false; // slack variables without a row are defined by a difference..
+            std::vector<bool> used(n_vars, false);
+            for (const auto &[x, l] : rows)
+                for (const auto &[v, c] : l.vars)
+                    used[v] = true;
+            for (const auto &[x, l] : s_i_rows)
+                for (const auto &[v, c] : l.vars)
+                    used[v] = true;
+            for (std::uint64_t i = 0, n = r.word(); r.ok() && i < n; ++i)
+            { // the reusable identifiers refer to unbounded variables, which appear nowhere..
+                const auto x = r.index(n_vars);
+                if (!r.ok() || basic[x] || used[x] || s_slacks[x] != slack_state::none || !s_vars[x].bounds[0].empty() || !s_vars[x].bounds[1].empty())
+                    return false;
+                used[x] = true;
+                s_free_vars.push_back(x);
+            }
+        }
+        if (!r.ok())
+            return false;
+
+        // we now restore the state..
+        for (auto &sv : s_vars)
+        {
+            auto &x = vars.emplace_back();
+            x.val = sv.val;
+            for (bool upper : {false, true})
+                for (const auto &[v, reason] : sv.bounds[upper])
+                    (upper ? x.ubs : x.lbs).push_back({v, reason < cs.size() ? &cs[reason].get() : nullptr});
+            x.refresh();
+            tableau.write().add_var();
+            r_bounds.emplace_back();
+        }
+        for (const auto &[x, l] : rows)
+            tableau.write().add_row(x, l);
+        for (const auto &[l, x] : s_exprs)
+            exprs.write().insert(l, x);
+        slacks = std::move(s_slacks);
+        n_d_rowless = static_cast<std::size_t>(std::count(slacks.cbegin(), slacks.cend(), slack_state::difference));
+        i_rows = std::move(s_i_rows);
+        free_vars = std::move(s_free_vars);
+        for (std::size_t i = 0; i < cs.size(); ++i)
+        {
+            auto &c = cs[i].get();
+            c.lbs.clear();
+            c.ubs.clear();
+            c.l_scales.clear();
+            c.u_scales.clear();
+            for (const bool upper : {false, true})
+                for (const auto &[x, v, sc] : s_cs[i][upper])
+                {
+                    (upper ? c.ubs : c.lbs).emplace(x, v);
+                    c.set_scale(x, upper, sc);
+                }
+        }
+        d_vars = std::move(s_d_vars);
+        for (utils::var x = 0; x < d_vars.size(); ++x)
+            if (d_vars[x].r != difference_var::role::none)
+                add_difference_edges(x);
+        for (const auto &[x, l] : rows)
+            update_violation(x);
+        return true;
+    }
+
+    bool solver::clone(solver &dst, const std::vector<std::reference_wrapper<const constraint>> &cs, const std::vector<std::reference_wrapper<constraint>> &dst_cs) const noexcept
+    {
+        assert(cs.size() == dst_cs.size());
+        if (batching || !dst.vars.empty() || !dst.levels.empty() || dst.batching)
+            return false;
+        std::unordered_map<const constraint *, const constraint *> to_dst;
+        for (std::size_t i = 0; i < cs.size(); ++i)
+            to_dst.emplace(&cs[i].get(), &dst_cs[i].get());
+        for (const auto &x : vars)
+            for (const auto *bs : {&x.lbs, &x.ubs})
+                for (const auto &b : *bs)
+                    if (b.reason && !to_dst.count(b.reason))
+                        return false;
+
+        dst.vars = vars;
+        dst.slacks = slacks;
+        dst.free_vars = free_vars;
+        dst.i_rows = i_rows;
+        for (auto &x : dst.vars)
+            for (auto *bs : {&x.lbs, &x.ubs})
+                for (auto &b : *bs)
+                    if (b.reason)
+                        b.reason = to_dst.at(b.reason);
+        for (std::size_t i = 0; i < cs.size(); ++i)
+        {
+            dst_cs[i].get().lbs = cs[i].get().lbs;
+            dst_cs[i].get().ubs = cs[i].get().ubs;
+            dst_cs[i].get().l_scales = cs[i].get().l_scales;
+            dst_cs[i].get().u_scales = cs[i].get().u_scales;
+        }
+        dst.exprs = exprs;
+        dst.a_overflow = a_overflow;
+        dst.tableau = tableau;
+        dst.violated = violated;
+        dst.r_bounds = r_bounds;
+        dst.d_graph = d_graph;
+        dst.d_vars = d_vars;
+        dst.n_d_slacks = n_d_slacks;
+        dst.n_d_rowless = n_d_rowless;
+        dst.p_rule = p_rule;
+        dst.f_presolve = f_presolve;
+        dst.e_fixed = e_fixed;
+        dst.c_minimize = c_minimize;
+        return true;
+    }
+
+    void solver::warm_start(const solver &other) noexcept
+    {
+        const overflow_scope scope(a_overflow);
+        assert(!batching);
+        const auto n = std::min(vars.size(), other.vars.size());
+        // we first bring into the basis the variables which are basic in `other`..
+        for (utils::var x = 0; x < n; ++x)
+            if (!is_basic(x) && other.is_basic(x))
+                for (const auto &o : tableau->column(x))
+                    if (const auto x_i = tableau->basic(o); x_i >= n || !other.is_basic(x_i))
+                    {
+                        pivot(x_i, x);
+                        break;
+                    }
+        // we then take the values of the non-basic variables, within their own bounds..
+        bool changed = false;
+        for (utils::var x = 0; x < vars.size(); ++x)
+            if (!is_basic(x))
+            {
+                auto v = x < n ? other.vars[x].val : vars[x].val;
+                if (v < vars[x].get_lb())
+                    v = vars[x].get_lb();
+                else if (v > vars[x].get_ub())
+                    v = vars[x].get_ub();
+                if (v != vars[x].val)
+                {
+                    vars[x].val = v;
+                    touch(x);
+                    FIRE_ON_VALUE_CHANGED(x);
+                    changed = true;
+                }
+            }
+        if (changed)
+            recompute_basic_values();
+    }
+
+    solver_snapshot solver::snapshot() const noexcept
+    {
+        const auto n_chunks = (vars.size() + solver_snapshot::chunk_size - 1) / solver_snapshot::chunk_size;
+        s_chunks.resize(n_chunks);
+        s_dirty.resize(n_chunks, true);
+        for (std::size_t i = 0; i < n_chunks; ++i)
+        {
+            const auto first = i * solver_snapshot::chunk_size;
+            const auto n = std::min(solver_snapshot::chunk_size, vars.size() - first);
+            if (!s_dirty[i] && s_chunks[i] && s_chunks[i]->vals.size() == n)
+                continue; // the chunk is shared with the previous snapshot..
+            auto c = std::make_shared<solver_snapshot::chunk>();
+            c->vals.reserve(n);
+            c->lbs.reserve(n);
+            c->ubs.reserve(n);
+            for (utils::var x = first; x < first + n; ++x)
+            {
+                c->vals.push_back(vars[x].val);
+                c->lbs.push_back(lb(x));
+                c->ubs.push_back(ub(x));
+            }
+            s_chunks[i] = std::move(c);
+            s_dirty[i] = false;
+        }
+        return solver_snapshot(s_chunks, vars.size());
+    }
+
+    void solver::move_to_bound(const utils::var x, const utils::inf_rational &v) noexcept
+    {
+        assert(!is_basic(x));
+        if (batching)
+            pending.push_back(x); // the value of `x` will be fixed when the batch is committed..
+        else
+            update(x, v);
+    }
+
+    bool solver::check() noexcept { return check(check_budget()) == check_result::sat; }
+
+    check_result solver::check(const check_budget &budget) noexcept
+    {
+        bool overflow = std::exchange(a_overflow, false); // the overflows since the last check, on which this one is built..
+        const auto res = [this, &overflow, &budget]
+        {
+            overflow_scope scope(overflow);
+            return simplex(budget);
+        }();
+        overflow = overflow || std::exchange(a_overflow, false); // the nested computations, e.g. the commit of a batch, report to the solver..
+        c_overflowed = overflow;
+        if (!overflow)
+            return res;
+        new_conflict(); // a conflict found on meaningless values proves nothing..
+        return check_result::unknown;
+    }
+
+    check_result solver::simplex(const check_budget &budget) noexcept
+    {
+        STAT_INC(n_checks);
+        STAT_TIMER(check_time);
+        commit();
+        if (!check_differences())
+        {
+            c_interrupted = false;
+            c_degenerate = 0;
+            FLUSH_NOTIFICATIONS();
+            return check_result::unsat;
+        }
+        if (!c_interrupted)
+        { // the pre-solve stages have not been performed yet..
+            if (e_fixed && !violated.empty())
+                eliminate_fixed();
+            if (f_presolve && !violated.empty())
+                float_presolve();
+        }
+
+        std::size_t n_pivots = 0;
+        while (!violated.empty())
+        {
+            if (arith_overflow)
+            { // the values are meaningless from now on, hence pivoting further might never end..
+                c_interrupted = false;
+                c_degenerate = 0;
+                FLUSH_NOTIFICATIONS();
+                return check_result::unknown;
+            }
+            if (n_pivots == budget.max_pivots || (budget.cancel && budget.cancel->load(std::memory_order_relaxed)) || (budget.deadline && std::chrono::steady_clock::now() >= *budget.deadline))
+            { // we keep the current basis, and the count of the degenerate pivots, for the next call..
+                c_interrupted = true;
+                FLUSH_NOTIFICATIONS();
+                return check_result::unknown;
+            }
+            ++n_pivots;
+            const bool bland = c_degenerate >= p_rule.bland_threshold; // after too many degenerate pivots we fall back to Bland's rule to guarantee termination..
+            const auto n_violated = violated.size();
+            const auto x_i = select_leaving(bland); // we select the variable `x_i`..
+            if (val(x_i) < vars[x_i].get_lb())
+            { // the value of `x_i` is below its lower bound..
+                if (const auto x_j = select_entering(x_i, true, bland); x_j) // var x_j can be used to increase the value of x_i..
+                    pivot_and_update(x_i, *x_j, vars[x_i].get_lb());
+                else // no var x_j can be used to increase the value of x_i, so the constraints are inconsistent..
+                {    // we generate an explanation for the conflict..
+                    STAT_INC(n_conflicts);
+                    new_conflict();
+                    explain_implied_ub(x_i, utils::rational::one); // we use the most restrictive upper bounds of the row `x_i = ...`..
+                    explain_lb(x_i, utils::rational::one);         // we use the most restrictive lower bound of x_i
+                    end_conflict();
+                    c_interrupted = false;
+                    c_degenerate = 0;
+                    FLUSH_NOTIFICATIONS();
+                    return check_result::unsat;
+                }
+            }
+            else
+            { // the value of `x_i` is above its upper bound..
+                assert(val(x_i) > vars[x_i].get_ub());
+                if (const auto x_j = select_entering(x_i, false, bland); x_j) // var x_j can be used to decrease the value of x_i..
+                    pivot_and_update(x_i, *x_j, vars[x_i].get_ub());
+                else // no var x_j can be used to decrease the value of x_i, so the constraints are inconsistent..
+                {    // we generate an explanation for the conflict..
+                    STAT_INC(n_conflicts);
+                    new_conflict();
+                    explain_implied_lb(x_i, utils::rational::one); // we use the most restrictive lower bounds of the row `x_i = ...`..
+                    explain_ub(x_i, utils::rational::one);         // we use the most restrictive upper bound of x_i
+                    end_conflict();
+                    c_interrupted = false;
+                    c_degenerate = 0;
+                    FLUSH_NOTIFICATIONS();
+                    return check_result::unsat;
+                }
+            }
+            if (violated.size() >= n_violated)
+                ++c_degenerate;
+        }
+        c_interrupted = false;
+        c_degenerate = 0;
+        FLUSH_NOTIFICATIONS();
+        return check_result::sat; // all the variables are within their bounds..
+    }
+
+    bool solver::check(const std::vector<pivot_rule> &rules, const std::vector<std::reference_wrapper<const constraint>> &cs) noexcept
+    {
+        const auto rule = p_rule;
+        if (!rules.empty())
+            p_rule = rules.front();
+        commit();
+        // we create the clones, along with the constraints receiving the bounds of the ones in `cs`..
+        std::vector<std::unique_ptr<solver>> workers;
+        std::vector<std::vector<constraint>> w_cs;
+        if (!batching && rules.size() > 1 && !violated.empty())
+        {
+            workers.reserve(rules.size() - 1);
+            w_cs.reserve(rules.size() - 1);
+            for (std::size_t i = 1; i < rules.size(); ++i)
+            {
+                auto &w = workers.emplace_back(std::make_unique<solver>());
+                auto &w_c = w_cs.emplace_back(cs.size());
+                std::vector<std::reference_wrapper<constraint>> dst_cs(w_c.begin(), w_c.end());
+                if (!clone(*w, cs, dst_cs))
+                { // the state cannot be cloned, hence we check alone..
+                    workers.clear();
+                    w_cs.clear();
+                    break;
+                }
+                w->p_rule = rules[i];
+            }
+        }
+        if (workers.empty())
+        {
+            const auto res = check(check_budget());
+            p_rule = rule;
+            return res == check_result::sat;
+        }
+
+        // the first worker reaching a conclusion stops the others..
+        constexpr std::size_t none = std::numeric_limits<std::size_t>::max();
+        std::atomic<bool> stop{false};
+        std::atomic<std::size_t> winner{none};
+        check_budget budget;
+        budget.cancel = &stop;
+        std::vector<check_result> results(rules.size(), check_result::unknown);
+        const auto run = [&](solver &s, const std::size_t i)
+        {
+            results[i] = s.check(budget);
+            if (std::size_t w = none; results[i] != check_result::unknown && winner.compare_exchange_strong(w, i))
+                stop.store(true, std::memory_order_relaxed);
+        };
+        std::vector<std::thread> threads;
+        try
+        {
+            threads.reserve(workers.size());
+            for (std::size_t i = 0; i < workers.size(); ++i)
+                threads.emplace_back(run, std::ref(*workers[i]), i + 1);
+        }
+        catch (const std::system_error &)
+        { // the system is short of resources, hence the clones without a thread stay out of the race..
+        }
+        catch (const std::bad_alloc &)
+        {
+        }
+        run(*this, 0);
+        for (auto &t : threads)
+            t.join();
+        p_rule = rule;
+
+        const auto i = winner.load();
+        if (i == none)
+        { // all the workers overflowed their rational arithmetic..
+            c_overflowed = true;
+            new_conflict();
+            return false;
+        }
+        if (i == 0) // this solver reached the conclusion..
+            return results[0] == check_result::sat;
+        const auto &w = *workers[i - 1];
+        if (results[i] == check_result::sat)
+        { // we import the solution of the winner, which leaves (almost) nothing to do..
+            warm_start(w);
+            return check();
+        }
+        // our own check has been cancelled, or has overflowed, yet the conclusion is reached, hence the next one starts afresh..
+        c_interrupted = false;
+        c_degenerate = 0;
+        c_overflowed = false;
+        // we map the conflict explanation of the winner back to our constraints..
+        const auto &w_c = w_cs[i - 1];
+        new_conflict();
+        for (std::size_t j = 0; j < w.cnfl.size(); ++j)
+        {
+            const auto k = static_cast<std::size_t>(&w.cnfl[j].get() - w_c.data());
+            assert(k < cs.size());
+            cnfl.push_back(cs[k]);
+            cnfl_coeffs.push_back(w.cnfl_coeffs[j]);
+        }
+        STAT_INC(n_conflicts);
+        TRACE_EVENT(conflict, cnfl.size());
+        return false;
+    }
+
+    std::optional<utils::inf_rational> solver::minimize(const utils::lin &l) noexcept
+    {
+        if (!check())
+            return std::nullopt;
+        bool overflow = false;
+        const auto min = [this, &overflow, &l]
+        {
+            overflow_scope scope(overflow);
+            return primal_simplex(l);
+        }();
+        if (overflow)
+        { // the overflows of the optimization are reported here, rather than by the next check..
+            c_overflowed = true;
+            return std::nullopt;
+        }
+        return min;
+    }
+
+    utils::inf_rational solver::primal_simplex(const utils::lin &l) noexcept
+    {
+        add_difference_rows(); // the variables are moved through the rows alone..
+        std::size_t n_degenerate = 0; // the number of iterations which did not improve the objective..
+        while (true)
+        {
+            if (arith_overflow)
+            { // the values are meaningless from now on, hence pivoting further might never end..
+                FLUSH_NOTIFICATIONS();
+                return val(l);
+            }
+            const bool bland = n_degenerate >= p_rule.bland_threshold;
+            // we express the objective in terms of the non-basic variables..
+            utils::lin obj = l;
+            substitute_basic(obj);
+
+            // we select a non-basic variable `x_j` whose move improves the objective, preferring the largest coefficient..
+            std::optional<utils::var> x_j;
+            utils::rational best;
+            for (const auto &[x, c] : obj.vars)
+                if (is_negative(c) ? vars[x].val < vars[x].get_ub() : is_positive(c) && vars[x].val > vars[x].get_lb())
+                    if (const auto abs_c = is_negative(c) ? neg(c) : c; !x_j || abs_c > best)
+                    {
+                        x_j = x;
+                        best = abs_c;
+                        if (bland)
+                            break; // the variables are sorted, hence this is the smallest one..
+                    }
+            if (!x_j)
+            { // no move improves the objective, which is hence at its minimum..
+                FLUSH_NOTIFICATIONS();
+                return val(l);
+            }
+            const bool increase = is_negative(obj.vars.at(*x_j));
+
+            // we look for the first bound hit by moving `x_j`, either its own or the one of a basic variable..
+            std::optional<utils::var> x_i;
+            utils::inf_rational x_i_v;
+            const auto &x_j_bound = increase ? vars[*x_j].get_ub() : vars[*x_j].get_lb();
+            const bool x_j_bounded = increase ? x_j_bound != utils::rational::positive_infinite : x_j_bound != utils::rational::negative_infinite;
+            utils::inf_rational delta = x_j_bounded ? (increase ? sub(x_j_bound, vars[*x_j].val) : sub(vars[*x_j].val, x_j_bound)) : utils::inf_rational(utils::rational::zero);
+            for (const auto &o : tableau->column(*x_j))
+            {
+                const auto x_k = tableau->basic(o);
+                const auto &a = tableau->coeff(o);
+                const bool k_increases = is_positive(a) == increase;
+                const auto &bound = k_increases ? vars[x_k].get_ub() : vars[x_k].get_lb();
+                if (k_increases ? bound == utils::rational::positive_infinite : bound == utils::rational::negative_infinite)
+                    continue; // `x_k` does not limit the move..
+                const auto d = div(k_increases ? sub(bound, vars[x_k].val) : sub(vars[x_k].val, bound), is_positive(a) ? a : neg(a));
+                if ((!x_j_bounded && !x_i) || d < delta || (bland && d == delta && x_i && x_k < *x_i))
+                {
+                    x_i = x_k;
+                    x_i_v = bound;
+                    delta = d;
+                }
+            }
+            if (!x_j_bounded && !x_i)
+            { // `x_j` can move indefinitely, hence the objective is unbounded..
+                FLUSH_NOTIFICATIONS();
+                return utils::inf_rational(utils::rational::negative_infinite);
+            }
+
+            if (delta == utils::rational::zero)
+                ++n_degenerate;
+            if (x_i)
+                pivot_and_update(*x_i, *x_j, x_i_v);
+            else
+                update(*x_j, x_j_bound);
+        }
+    }
+
+    std::optional<utils::inf_rational> solver::maximize(const utils::lin &l) noexcept
+    {
+        bool overflow = false;
+        const auto obj = [&overflow, &l]
+        {
+            overflow_scope scope(overflow);
+            return sub(utils::lin(utils::rational::zero), l);
+        }();
+        if (overflow)
+        {
+            c_overflowed = true;
+            return std::nullopt;
+        }
+        const auto min = minimize(obj);
+        if (!min)
+            return std::nullopt;
+        if (*min == utils::rational::negative_infinite)
+            return utils::inf_rational(utils::rational::positive_infinite);
+        return neg(*min);
+    }
+
+    bool solver::propagate(const std::size_t budget) noexcept
+    {
+        const overflow_scope scope(a_overflow);
+        commit();
+        add_difference_rows(); // the bounds are propagated through the rows alone..
+        i_bounds.clear();
+        std::unordered_map<utils::var, derived_bound> d_lbs, d_ubs; // the derived bounds, tighter than the ones set on the variables..
+        // returns the current (lower or upper) bound of `x`, either derived or set on the variable..
+        const auto bound = [this, &d_lbs, &d_ubs](const utils::var x, const bool upper) -> const utils::inf_rational &
+        {
+            auto &d = upper ? d_ubs : d_lbs;
+            if (const auto it = d.find(x); it != d.end())
+                return it->second.v;
+            return upper ? vars[x].get_ub() : vars[x].get_lb();
+        };
+        // adds to `coeffs` the reasons of the current (lower or upper) bound of `x`, with their multipliers scaled by `w`..
+        const auto explain = [this, &d_lbs, &d_ubs](std::vector<std::pair<const constraint *, utils::rational>> &coeffs, const utils::var x, const bool upper, const utils::rational &w)
+        {
+            auto &d = upper ? d_ubs : d_lbs;
+            if (const auto it = d.find(x); it != d.end())
+                for (const auto &[c, m] : it->second.coeffs)
+                    coeffs.emplace_back(c, mul(m, w));
+            else if (const auto r = vars[x].bound_reason(upper); r)
+                coeffs.emplace_back(r, mul(upper ? w : neg(w), r->scale(x, upper)));
+        };
+
+        // the rows to be visited, starting from all of them..
+        std::vector<utils::var> queue;
+        std::vector<bool> queued(vars.size(), false);
+        for (const auto &r : tableau->rows())
+        {
+            queue.push_back(r.basic);
+            queued[r.basic] = true;
+        }
+        std::vector<std::pair<utils::var, utils::rational>> ts; // the terms of the row, as `sum_k c_k * x_k = 0`..
+        std::vector<std::optional<utils::inf_rational>> mins, maxs;
+        std::vector<std::pair<const constraint *, utils::rational>> coeffs;
+        std::unordered_map<const constraint *, std::size_t> idx;
+        bool consistent = true;
+        std::size_t n_visits = 0;
+        for (std::size_t head = 0; head < queue.size() && n_visits < budget && consistent; ++head, ++n_visits)
+        {
+            const auto x_i = queue[head];
+            queued[x_i] = false;
+            if (!is_basic(x_i))
+                continue;
+            ts.clear();
+            ts.emplace_back(x_i, utils::rational::one);
+            for (const auto &[v, c, _] : tableau->terms(x_i))
+                ts.emplace_back(v, neg(c));
+
+            // the minimum and the maximum of each term, and the finite parts of their sums with the number of their infinite contributions..
+            mins.clear();
+            maxs.clear();
+            utils::inf_rational min_sum, max_sum;
+            std::size_t min_inf = 0, max_inf = 0;
+            for (const auto &[v, c] : ts)
+            {
+                const auto &l = bound(v, !is_positive(c));
+                const auto &u = bound(v, is_positive(c));
+                if (l == utils::rational::negative_infinite || l == utils::rational::positive_infinite)
+                {
+                    mins.emplace_back(std::nullopt);
+                    ++min_inf;
+                }
+                else
+                {
+                    mins.emplace_back(mul(c, l));
+                    min_sum = add(min_sum, *mins.back());
+                }
+                if (u == utils::rational::negative_infinite || u == utils::rational::positive_infinite)
+                {
+                    maxs.emplace_back(std::nullopt);
+                    ++max_inf;
+                }
+                else
+                {
+                    maxs.emplace_back(mul(c, u));
+                    max_sum = add(max_sum, *maxs.back());
+                }
+            }
+
+            for (std::size_t t = 0; t < ts.size() && consistent; ++t)
+            {
+                const auto [x_t, c_t] = ts[t];
+                for (const bool from_min : {true, false})
+                { // `c_t * x_t <= -min(rest)` and `c_t * x_t >= -max(rest)`..
+                    const auto &b_t = from_min ? mins[t] : maxs[t];
+                    const auto n_inf = (from_min ? min_inf : max_inf) - (b_t ? 0 : 1);
+                    if (n_inf > 0)
+                        continue; // the rest of the row is unbounded..
+                    utils::inf_rational rest = from_min ? min_sum : max_sum;
+                    if (b_t)
+                        rest = sub(rest, *b_t);
+                    const bool upper = from_min == is_positive(c_t);
+                    if ((upper ? d_ubs : d_lbs).count(x_t))
+                        continue; // bounds are derived at most once, cutting the (possibly endless) sequences of ever tighter bounds..
+                    const auto v = div(neg(rest), c_t);
+                    if (upper ? v >= bound(x_t, true) : v <= bound(x_t, false))
+                        continue; // the derived bound is not tighter than the current one..
+
+                    // we explain the derived bound through the bounds of the rest of the row..
+                    coeffs.clear();
+                    idx.clear();
+                    for (std::size_t k = 0; k < ts.size(); ++k)
+                        if (k != t)
+                        {
+                            const auto &[x_k, c_k] = ts[k];
+                            const auto w = div(c_k, c_t);
+                            explain(coeffs, x_k, from_min != is_positive(c_k), is_negative(w) ? neg(w) : w);
+                        }
+                    derived_bound d{v, {}};
+                    for (const auto &[c, m] : coeffs)
+                        if (const auto [it, added] = idx.emplace(c, d.coeffs.size()); added)
+                            d.coeffs.emplace_back(c, m);
+                        else
+                            d.coeffs[it->second].second = add(d.coeffs[it->second].second, m);
+
+                    if (upper ? v < bound(x_t, false) : v > bound(x_t, true))
+                    { // the derived bound is inconsistent with the opposite bound..
+                        STAT_INC(n_conflicts);
+                        new_conflict();
+                        for (const auto &[c, m] : d.coeffs)
+                            add_to_conflict(*c, m);
+                        coeffs.clear();
+                        explain(coeffs, x_t, !upper, utils::rational::one);
+                        for (const auto &[c, m] : coeffs)
+                            add_to_conflict(*c, m);
+                        end_conflict();
+                        consistent = false;
+                        break;
+                    }
+                    (upper ? d_ubs : d_lbs)[x_t] = std::move(d);
+
+                    // we revisit the rows containing `x_t`..
+                    if (is_basic(x_t))
+                    {
+                        if (x_t != x_i && !queued[x_t])
+                        {
+                            queue.push_back(x_t);
+                            queued[x_t] = true;
+                        }
+                    }
+                    else
+                        for (const auto &o : tableau->column(x_t))
+                            if (const auto x_b = tableau->basic(o); x_b != x_i && !queued[x_b])
+                            {
+                                queue.push_back(x_b);
+                                queued[x_b] = true;
+                            }
+                }
+            }
+        }
+
+        // we collect the derived bounds, notifying the listeners..
+        for (const bool upper : {false, true})
+            for (const auto &[x, d] : upper ? d_ubs : d_lbs)
+            {
+                auto &ib = i_bounds.emplace_back();
+                ib.x = x;
+                ib.upper = upper;
+                ib.value = d.v;
+                for (const auto &[c, m] : d.coeffs)
+                    if (!is_zero(m))
+                        ib.reasons.push_back(*c);
+            }
+        std::sort(i_bounds.begin(), i_bounds.end(), [](const implied_bound &a, const implied_bound &b)
+                  { return a.x < b.x || (a.x == b.x && a.upper < b.upper); });
+#ifdef LINSPIRE_ENABLE_LISTENERS
+        for (const auto &ib : i_bounds)
+            if (ib.x < listening.size())
+                for (auto &l : listening[ib.x].ls)
+                    l->on_bound_propagated(ib.x);
+#endif
+        return consistent;
+    }
+
+    void solver::float_presolve() noexcept
+    {
+        // we build the floating-point shadow of the tableau, of the values and of the bounds..
+        float_tableau f_tableau(*tableau, [](const utils::rational &c)
+                                { return to_double(c); });
+        std::vector<double> f_val, f_lb, f_ub;
+        f_val.reserve(vars.size());
+        f_lb.reserve(vars.size());
+        f_ub.reserve(vars.size());
+        for (const auto &x : vars)
+        { // strict bounds are approximated by their rational part, the exact procedure takes care of the infinitesimals..
+            f_val.push_back(to_double(x.val.get_rational()));
+            f_lb.push_back(to_double(x.get_lb().get_rational()));
+            f_ub.push_back(to_double(x.get_ub().get_rational()));
+        }
+
+        // we repair the bound violations using Bland's rule, giving up when rounding errors prevent progress..
+        const auto max_pivots = 10 * (vars.size() + f_tableau.size());
+        for (std::size_t n_pivots = 0; n_pivots < max_pivots; ++n_pivots)
+        {
+            // we select the smallest violated basic variable `x_i`..
+            std::optional<utils::var> x_i;
+            for (const auto &r : f_tableau.rows())
+                if ((f_val[r.basic] < f_lb[r.basic] - float_eps || f_val[r.basic] > f_ub[r.basic] + float_eps) && (!x_i || r.basic < *x_i))
+                    x_i = r.basic;
+            if (!x_i)
+                break; // all the variables are (approximately) within their bounds..
+            const bool increase = f_val[*x_i] < f_lb[*x_i];
+            // we select the smallest non-basic variable `x_j` which can move `x_i` in the required direction..
+            std::optional<utils::var> x_j;
+            for (const auto &[v, c, _] : f_tableau.terms(*x_i))
+                if (!is_negligible(c) && (increase == (c > 0) ? f_val[v] < f_ub[v] - float_eps : f_val[v] > f_lb[v] + float_eps))
+                {
+                    x_j = v;
+                    break;
+                }
+            if (!x_j)
+                break; // the constraints are (likely) inconsistent, the exact procedure will find the explanation..
+
+            // we move `x_i` to its violated bound and update the values of the basic variables accordingly..
+            const double v = increase ? f_lb[*x_i] : f_ub[*x_i];
+            const double theta = (v - f_val[*x_i]) / *f_tableau.coeff(*x_i, *x_j);
+            f_val[*x_i] = v;
+            f_val[*x_j] += theta;
+            for (const auto &o : f_tableau.column(*x_j))
+                if (const auto x_k = f_tableau.basic(o); x_k != *x_i)
+                    f_val[x_k] += f_tableau.coeff(o) * theta;
+            f_tableau.pivot(*x_i, *x_j);
+        }
+
+        // we replay the final basis in exact arithmetic: each exact basic variable which is non-basic in the shadow is pivoted with a variable which is basic in the shadow, but not in the exact tableau..
+        for (const auto &r : f_tableau.rows())
+            if (!is_basic(r.basic))
+            {
+                std::optional<utils::var> x_i;
+                for (const auto &o : tableau->column(r.basic))
+                    if (!f_tableau.is_basic(tableau->basic(o)))
+                    {
+                        x_i = tableau->basic(o);
+                        break;
+                    }
+                if (!x_i)
+                    break; // the shadow basis is singular in exact arithmetic, so we keep the exact basis reached so far..
+                pivot(*x_i, r.basic);
+            }
+
+        // we move the non-basic variables to the bounds they reached in the shadow, keeping them within their bounds otherwise..
+        for (utils::var x = 0; x < vars.size(); ++x)
+            if (!is_basic(x))
+            {
+                auto v = vars[x].val;
+                if (f_lb[x] > -std::numeric_limits<double>::infinity() && std::abs(f_val[x] - f_lb[x]) <= float_eps)
+                    v = vars[x].get_lb();
+                else if (f_ub[x] < std::numeric_limits<double>::infinity() && std::abs(f_val[x] - f_ub[x]) <= float_eps)
+                    v = vars[x].get_ub();
+                if (v < vars[x].get_lb()) // `x` might have left the exact basis while violating its bounds..
+                    v = vars[x].get_lb();
+                else if (v > vars[x].get_ub())
+                    v = vars[x].get_ub();
+                if (v != vars[x].val)
+                {
+                    vars[x].val = v;
+                    touch(x);
+                    FIRE_ON_VALUE_CHANGED(x);
+                }
+            }
+        recompute_basic_values();
+    }
+
+    void solver::eliminate_fixed() noexcept
+    {
+        // we collect the fixed basic variables first, since pivoting rewrites the rows..
+        std::vector<utils::var> fixed;
+        for (const auto &r : tableau->rows())
+            if (vars[r.basic].get_lb() == vars[r.basic].get_ub())
+                fixed.push_back(r.basic);
+        for (const auto &x_i : fixed)
+        {
+            assert(is_basic(x_i)); // a pivot only takes its leaving variable out of the basis..
+            // we eliminate the non-fixed variable appearing in the fewest rows, so as to limit the fill-in..
+            std::optional<utils::var> x_j;
+            for (const auto &[v, c, _] : tableau->terms(x_i))
+                if (vars[v].get_lb() != vars[v].get_ub() && (!x_j || tableau->column(v).size() < tableau->column(*x_j).size()))
+                    x_j = v;
+            if (x_j) // `x_i` becomes non-basic at its value, hence it can no longer move..
+                pivot_and_update(x_i, *x_j, vars[x_i].get_lb());
+        }
+    }
+
+    void solver::recompute_basic_values() noexcept
+    {
+        for (const auto &r : tableau->rows())
+        {
+            utils::inf_rational v(utils::rational::zero);
+            for (const auto &[x, c, _] : r.terms)
+                add_mul(v, c, vars[x].val);
+            if (v != vars[r.basic].val)
+            {
+                vars[r.basic].val = v;
+                touch(r.basic);
+                FIRE_ON_VALUE_CHANGED(r.basic);
+            }
+            update_violation(r.basic);
+        }
+    }
+
+    utils::rational solver::normalize(utils::lin &l) noexcept
+    {
+        if (l.vars.empty())
+            return utils::rational::one;
+        constexpr auto min = std::numeric_limits<integer_type>::min(); // neither negated nor passed to `std::gcd`..
+        for (const auto &[v, c] : l.vars)
+            if (c.numerator() == min)
+                return utils::rational::one; // the expression cannot even be negated, hence we leave it untouched..
+        if (l.known_term.numerator() == min)
+            return utils::rational::one;
+        const bool reversed = is_negative(l.vars.cbegin()->second);
+        // the factor is the least common multiple of the denominators over the greatest common divisor of the numerators..
+        integer_type num = 0, den = 1;
+        bool overflow = false;
+        for (const auto &[v, c] : l.vars)
+        {
+            num = std::gcd(num, c.numerator());
+            if (mul_overflow(den / std::gcd(den, c.denominator()), c.denominator(), den))
+            {
+                overflow = true;
+                break;
+            }
+        }
+        // each coefficient `n / d` becomes the integer `(n / num) * (den / d)`, and the known term `n / d` becomes `((n / g_n) * (den / g_d)) / ((d / g_d) * (num / g_n))`..
+        std::vector<integer_type> cs;
+        integer_type k_num = 0, k_den = 1;
+        if (!overflow)
+        {
+            cs.reserve(l.vars.size());
+            for (const auto &[v, c] : l.vars)
+                if (integer_type r; mul_overflow(c.numerator() / num, den / c.denominator(), r) || r == min)
+                {
+                    overflow = true;
+                    break;
+                }
+                else
+                    cs.push_back(reversed ? -r : r);
+        }
+        if (!overflow)
+        {
+            const auto g_n = std::gcd(l.known_term.numerator(), num), g_d = std::gcd(l.known_term.denominator(), den);
+            overflow = mul_overflow(l.known_term.numerator() / g_n, den / g_d, k_num) || mul_overflow(l.known_term.denominator() / g_d, num / g_n, k_den) || k_num == min;
+        }
+        if (overflow)
+        { // only the sign of the expression is fixed..
+            if (!reversed)
+                return utils::rational::one;
+            for (auto &[v, c] : l.vars)
+                c = -c;
+            l.known_term = -l.known_term;
+            return -utils::rational::one;
+        }
+        utils::rational m(den, num);
+        if (reversed)
+            m = -m;
+        if (m == utils::rational::one)
+            return m;
+        std::size_t i = 0;
+        for (auto &[v, c] : l.vars)
+            c = utils::rational(cs[i++]);
+        l.known_term = utils::rational(reversed ? -k_num : k_num, k_den);
+        return m;
+    }
+
+    std::optional<solver::difference> solver::as_difference(const utils::lin &l) noexcept
+    {
+        if (l.vars.size() != 2)
+            return std::nullopt;
+        const auto &[v0, c0] = *l.vars.cbegin();
+        const auto &[v1, c1] = *std::next(l.vars.cbegin());
+        if (c0 != neg(c1))
+            return std::nullopt;
+        if (is_positive(c0))
+            return difference{v0, v1, c0};
+        else
+            return difference{v1, v0, c1};
+    }
+
+    solver::difference solver::scale(const difference &d, const utils::rational &m) noexcept
+    {
+        const auto a = mul(d.a, m);
+        if (is_positive(a))
+            return difference{d.x, d.y, a};
+        else
+            return difference{d.y, d.x, neg(a)};
+    }
+
+    bool solver::new_difference(const utils::var s, const difference &d) noexcept
+    {
+        if (d.x >= s || d.y >= s)
+            return false; // the slack variable might outlive its variables..
+        if (d_vars.size() <= s)
+            d_vars.resize(s + 1);
+        if (d_vars[s].r != difference_var::role::none || d_vars[d.x].r == difference_var::role::difference || d_vars[d.y].r == difference_var::role::difference)
+            return false;
+        new_vertex(d.x);
+        new_vertex(d.y);
+        d_vars[s].r = difference_var::role::difference;
+        d_vars[s].d = d;
+        add_difference_edges(s);
+        return true;
+    }
+
+    utils::lin solver::to_lin(const difference &d) noexcept
+    {
+        utils::lin l;
+        l.vars.emplace(d.x, d.a);
+        l.vars.emplace(d.y, neg(d.a));
+        return l;
+    }
+
+    void solver::add_difference_rows() noexcept
+    {
+        if (!n_d_rowless)
+            return;
+        for (utils::var x = 0; x < d_vars.size(); ++x)
+            if (slacks[x] == slack_state::difference)
+            {
+                auto l = to_lin(d_vars[x].d);
+                substitute_basic(l);
+                vars[x].val = val(l);
+                touch(x);
+                FIRE_ON_VALUE_CHANGED(x);
+                slacks[x] = slack_state::active;
+                new_row(x, std::move(l));
+            }
+        n_d_rowless = 0;
+    }
+
+    void solver::new_vertex(const utils::var x) noexcept
+    {
+        if (d_vars[x].r != difference_var::role::none)
+            return;
+        d_vars[x].r = difference_var::role::vertex;
+        add_difference_edges(x);
+    }
+
+    void solver::add_difference_edges(const utils::var x) noexcept
+    {
+        const auto &dv = d_vars[x];
+        if (dv.r == difference_var::role::vertex)
+        {
+            d_graph.add_edge(2 * x, x + 1, 0);     // `-x <= -lb(x)`..
+            d_graph.add_edge(2 * x + 1, 0, x + 1); // `x <= ub(x)`..
+        }
+        else
+        {
+            assert(dv.r == difference_var::role::difference);
+            d_graph.add_edge(2 * x, dv.d.x + 1, dv.d.y + 1);     // `y - x <= -lb(s) / a`..
+            d_graph.add_edge(2 * x + 1, dv.d.y + 1, dv.d.x + 1); // `x - y <= ub(s) / a`..
+            ++n_d_slacks;
+        }
+        update_difference_edges(x);
+    }
+
+    void solver::remove_difference(const utils::var x) noexcept
+    {
+        if (x >= d_vars.size() || d_vars[x].r == difference_var::role::none)
+            return;
+        if (d_vars[x].r == difference_var::role::difference)
+            --n_d_slacks;
+        d_graph.remove_edge(2 * x);
+        d_graph.remove_edge(2 * x + 1);
+        d_vars[x] = difference_var();
+    }
+
+    void solver::update_difference_edges(const utils::var x) noexcept
+    {
+        const auto &dv = d_vars[x];
+        const auto &l = vars[x].get_lb();
+        const auto &u = vars[x].get_ub();
+        if (l == utils::rational::negative_infinite)
+            d_graph.unset_weight(2 * x);
+        else
+            d_graph.set_weight(2 * x, dv.r == difference_var::role::vertex ? neg(l) : neg(div(l, dv.d.a)));
+        if (u == utils::rational::positive_infinite)
+            d_graph.unset_weight(2 * x + 1);
+        else
+            d_graph.set_weight(2 * x + 1, dv.r == difference_var::role::vertex ? u : div(u, dv.d.a));
+    }
+
+    bool solver::check_differences() noexcept
+    {
+        if (!d_graph.check())
+        { // the bounds on the negative cycle are inconsistent..
+            STAT_INC(n_conflicts);
+            new_conflict();
+            for (const auto &e : d_graph.get_cycle())
+            {
+                const auto x = e / 2;
+                const bool upper = e % 2;
+                // the edges of a difference are scaled by its coefficient, so that the cycle sums up to zero..
+                const auto m = d_vars[x].r == difference_var::role::difference ? div(utils::rational::one, d_vars[x].d.a) : utils::rational::one;
+                if (const auto r = vars[x].bound_reason(upper); r)
+                    add_to_conflict(*r, mul(upper ? m : neg(m), r->scale(x, upper)));
+            }
+            end_conflict();
+            return false;
+        }
+        if (!n_d_slacks || !differences_only())
+            return true;
+        // the slack variables without a row are bounded through their differences alone..
+        bool rowless_violated = false;
+        if (n_d_rowless)
+            for (utils::var x = 0; x < d_vars.size() && !rowless_violated; ++x)
+                if (slacks[x] == slack_state::difference)
+                {
+                    const auto &d = d_vars[x].d;
+                    const auto v = mul(d.a, sub(vars[d.x].val, vars[d.y].val));
+                    rowless_violated = v < vars[x].get_lb() || v > vars[x].get_ub();
+                }
+        if (!violated.empty() || rowless_violated)
+        { // all the rows define differences, hence the potentials are a solution which needs no pivoting..
+            const auto zero = d_graph.potential(0);
+            bool changed = false;
+            for (utils::var x = 0; x < d_vars.size(); ++x)
+                if (d_vars[x].r != difference_var::role::none && !is_basic(x))
+                {
+                    const auto &d = d_vars[x].d;
+                    const auto v = d_vars[x].r == difference_var::role::vertex ? sub(d_graph.potential(x + 1), zero) : mul(d.a, sub(d_graph.potential(d.x + 1), d_graph.potential(d.y + 1)));
+                    if (v != vars[x].val)
+                    {
+                        vars[x].val = v;
+                        touch(x);
+                        FIRE_ON_VALUE_CHANGED(x);
+                        changed = true;
+                    }
+                }
+            if (changed)
+                recompute_basic_values();
+        }
+        else // the slack variables without a row take the values of their differences..
+            for (utils::var x = 0; x < d_vars.size() && n_d_rowless; ++x)
+                if (slacks[x] == slack_state::difference)
+                {
+                    const auto &d = d_vars[x].d;
+                    const auto v = mul(d.a, sub(vars[d.x].val, vars[d.y].val));
+                    if (v != vars[x].val)
+                    {
+                        vars[x].val = v;
+                        touch(x);
+                        FIRE_ON_VALUE_CHANGED(x);
+                    }
+                }
+        return true;
+    }
+
+    utils::var solver::select_leaving(const bool bland) const noexcept
+    {
+        assert(!violated.empty());
+        if (bland || p_rule.leaving == leaving_rule::bland)
+            return *violated.cbegin(); // we select the smallest violated basic variable..
+
+        // we select the basic variable with the largest (or the smallest) violation, breaking ties by the smallest variable..
+        auto x_i = *violated.cbegin();
+        auto x_i_viol = violation(x_i);
+        for (auto it = std::next(violated.cbegin()); it != violated.cend(); ++it)
+            if (auto viol = violation(*it); p_rule.leaving == leaving_rule::max_violation ? viol > x_i_viol : viol < x_i_viol)
+            {
+                x_i = *it;
+                x_i_viol = std::move(viol);
+            }
+        return x_i;
+    }
+
+    std::optional<utils::var> solver::select_entering(const utils::var x_i, const bool increase, const bool bland) const noexcept
+    {
+        assert(is_basic(x_i));
+        const auto rule = bland ? entering_rule::bland : p_rule.entering;
+        std::optional<utils::var> x_j;
+        utils::rational x_j_score = utils::rational::zero; // the score of the current candidate, the higher the better..
+        bool x_j_unbounded = false;
+        for (const auto &[v, c, _] : tableau->terms(x_i))
+        {
+            // `v` can be used to move `x_i` in the required direction if it can move in the direction given by the sign of its coefficient..
+            const bool up = increase == is_positive(c);
+            if (up ? val(v) >= ub(v) : val(v) <= lb(v))
+                continue; // `v` cannot move in the required direction..
+            switch (rule)
+            {
+            case entering_rule::bland: // we select the first (i.e., the smallest) suitable variable..
+                return v;
+            case entering_rule::min_occurrences: // we select the suitable variable appearing in the fewest rows..
+                if (!x_j || tableau->column(v).size() < tableau->column(*x_j).size())
+                    x_j = v;
+                break;
+            case entering_rule::greatest_slack:
+            { // we select the suitable variable which can move `x_i` the most before reaching its own bound..
+                const auto bound = up ? ub(v) : lb(v);
+                if (bound == (up ? utils::rational::positive_infinite : utils::rational::negative_infinite))
+                {
+                    if (!x_j_unbounded)
+                    { // unbounded variables have the largest slack..
+                        x_j = v;
+                        x_j_unbounded = true;
+                    }
+                }
+                else if (!x_j_unbounded)
+                {
+                    const auto slack = up ? sub(bound, val(v)) : sub(val(v), bound);
+                    const auto score = mul(is_positive(c) ? c : neg(c), slack.get_rational());
+                    if (!x_j || score > x_j_score)
+                    {
+                        x_j = v;
+                        x_j_score = score;
+                    }
+                }
+                break;
+            }
+            case entering_rule::steepest_edge:
+            { // we approximate the steepest edge norm by the number of rows in which the variable appears..
+                const auto score = div(mul(c, c), utils::rational(static_cast<integer_type>(tableau->column(v).size() + 1)));
+                if (!x_j || score > x_j_score)
+                {
+                    x_j = v;
+                    x_j_score = score;
+                }
+                break;
+            }
+            }
+        }
+        return x_j;
+    }
+
+    utils::inf_rational solver::violation(const utils::var x) const noexcept
+    {
+        assert(is_basic(x));
+        if (vars[x].val < vars[x].get_lb())
+            return sub(vars[x].get_lb(), vars[x].val);
+        if (vars[x].val > vars[x].get_ub())
+            return sub(vars[x].val, vars[x].get_ub());
+        return utils::rational::zero;
+    }
+
+    bool solver::match(const utils::lin &l0, const utils::lin &l1) const noexcept { return lb(l0) <= ub(l1) && ub(l0) >= lb(l1); }
+
+    namespace
+    {
+        /**
+         * @brief Calls `f(i)` for each `i` in `[0, n)`, splitting the range in contiguous chunks among at most `n_threads` threads.
+         *
+         * The calling thread processes the first chunk. Ranges too short to amortize the creation of the threads are processed sequentially,
+         * as are the chunks whose thread cannot be created.
+         */
+        template <typename F>
+        void parallel_for(const std::size_t n, std::size_t n_threads, F &&f) noexcept
+        {
+            constexpr std::size_t min_chunk = 256; // the minimum number of items worth a thread..
+            n_threads = std::max<std::size_t>(1, std::min(n_threads, n / min_chunk));
+            const auto chunk = (n + n_threads - 1) / n_threads;
+            std::vector<std::thread> workers;
+            std::atomic<bool> overflow{false}; // the overflows of the workers, which are reported to the calling thread..
+            std::size_t t = 1; // the first chunk which has not been handed to a thread..
+            try
+            {
+                workers.reserve(n_threads - 1);
+                for (; t < n_threads; ++t)
+                    workers.emplace_back([&f, &overflow, from = t * chunk, to = std::min(n, (t + 1) * chunk)]
+                                         { for (auto i = from; i < to; ++i) f(i);
+                                           if (arith_overflow) overflow.store(true, std::memory_order_relaxed); });
+            }
+            catch (const std::system_error &)
+            { // the system is short of resources, hence the remaining chunks are processed by the calling thread..
+            }
+            catch (const std::bad_alloc &)
+            {
+            }
+            for (std::size_t i = 0; i < std::min(n, chunk); ++i)
+                f(i);
+            for (auto i = t * chunk; i < n; ++i)
+                f(i);
+            for (auto &w : workers)
+                w.join();
+            if (overflow.load(std::memory_order_relaxed))
+                arith_overflow = true;
+        }
+
+        /**
+         * @brief Returns the lower and upper bounds of `l` from the gathered bounds of its variables.
+         */
+        template <typename DB>
+        std::pair<utils::inf_rational, utils::inf_rational> dense_lin_bounds(const utils::lin &l, const DB &db) noexcept
+        {
+            std::pair<utils::inf_rational, utils::inf_rational> b(l.known_term, l.known_term);
+            for (const auto &[v, c] : l.vars)
+            {
+                const auto i = db.slot[v];
+                if (is_positive(c))
+                {
+                    add_mul(b.first, c, db.lbs[i]);
+                    add_mul(b.second, c, db.ubs[i]);
+                }
+                else
+                {
+                    add_mul(b.first, c, db.ubs[i]);
+                    add_mul(b.second, c, db.lbs[i]);
+                }
+            }
+            return b;
+        }
+    } // namespace
+
+    void solver::gather_bounds(const utils::lin &l, dense_bounds &db) const noexcept
+    {
+        for (const auto &[v, c] : l.vars)
+            if (db.slot[v] == dense_bounds::npos)
+            {
+                db.slot[v] = db.lbs.size();
+                db.lbs.push_back(lb(v));
+                db.ubs.push_back(ub(v));
+            }
+    }
+
+    std::vector<std::pair<utils::inf_rational, utils::inf_rational>> solver::bounds(const std::vector<utils::lin> &ls, std::size_t n_threads) const noexcept
+    {
+        dense_bounds db;
+        db.slot.assign(vars.size(), dense_bounds::npos);
+        for (const auto &l : ls) // the implied bounds are resolved, and cached, by the calling thread only..
+            gather_bounds(l, db);
+        std::vector<std::pair<utils::inf_rational, utils::inf_rational>> res(ls.size());
+        parallel_for(ls.size(), n_threads, [&](const std::size_t i)
+                     { res[i] = dense_lin_bounds(ls[i], db); });
+        return res;
+    }
+
+    std::vector<utils::inf_rational> solver::vals(const std::vector<utils::lin> &ls, std::size_t n_threads) const noexcept
+    { // the values of the basic variables are maintained by the tableau, hence the variables can be read directly..
+        std::vector<utils::inf_rational> res(ls.size());
+        parallel_for(ls.size(), n_threads, [&](const std::size_t i)
+                     {
+                         utils::inf_rational v(ls[i].known_term);
+                         for (const auto &[x, c] : ls[i].vars)
+                             add_mul(v, c, vars[x].val);
+                         res[i] = std::move(v); });
+        return res;
+    }
+
+    std::vector<bool> solver::match(const std::vector<std::pair<utils::lin, utils::lin>> &ps, std::size_t n_threads) const noexcept
+    {
+        dense_bounds db;
+        db.slot.assign(vars.size(), dense_bounds::npos);
+        for (const auto &[l0, l1] : ps)
+        {
+            gather_bounds(l0, db);
+            gather_bounds(l1, db);
+        }
+        std::vector<char> res(ps.size()); // unlike std::vector<bool>, distinct elements can be written by distinct threads..
+        parallel_for(ps.size(), n_threads, [&](const std::size_t i)
+                     {
+                         const auto [lb0, ub0] = dense_lin_bounds(ps[i].first, db);
+                         const auto [lb1, ub1] = dense_lin_bounds(ps[i].second, db);
+                         res[i] = lb0 <= ub1 && ub0 >= lb1; });
+        return std::vector<bool>(res.begin(), res.end());
+    }
+
+    bool solver::set_lb(const utils::var x, const utils::inf_rational &v, std::optional<std::reference_wrapper<constraint>> reason, const utils::rational &scale) noexcept
+    {
+        assert(x < vars.size());
+        assert(v > utils::rational::negative_infinite);
+        LOG_TRACE("x" << std::to_string(x) << " = " << utils::to_string(val(x)) << " [" << utils::to_string(lb(x)) << " -> " << utils::to_string(v) << ", " << utils::to_string(ub(x)) << "]");
+        TRACE_EVENT(lower_bound, x);
+        if (slacks[x] == slack_state::inactive)
+            reactivate(x);
+        if (v > ub(x))
+        { // inconsistent bound..
+            STAT_INC(n_conflicts);
+            new_conflict();
+            if (reason)
+                add_to_conflict(reason->get(), neg(scale));
+            explain_ub(x, utils::rational::one); // we use the most restrictive upper bound of x
+            end_conflict();
+            return false;
+        }
+        if (reason)
+        { // we have a reason for this bound..
+            if (auto it = reason->get().lbs.find(x); it != reason->get().lbs.end())
+            { // we already have a lower bound for this variable in the reason..
+                if (it->second < v)
+                { // we update the lower bound only if the new one is more restrictive..
+                    vars.at(x).unset_lb(it->second, *reason);
+                    trail_bound(x, false, v, &reason->get(), true, it->second, reason->get().scale(x, false));
+                    it->second = v;
+                    reason->get().set_scale(x, false, scale);
+                }
+                else
+                    trail_bound(x, false, v, &reason->get());
+            }
+            else
+            {
+                trail_bound(x, false, v, &reason->get(), true);
+                reason->get().lbs.emplace(x, v);
+                reason->get().set_scale(x, false, scale);
+            }
+        }
+        else
+            trail_bound(x, false, v, nullptr);
+        vars.at(x).set_lb(v, reason);
+        invalidate_implied_bounds(x);
+        if (is_basic(x))
+            update_violation(x);
+        else if (val(x) < v)
+        {
+            if (slacks[x] == slack_state::difference)
+            { // the slack variable has no row to update, and its difference might imply a tighter bound, hence `check_differences` will resync it..
+                vars[x].val = v;
+                touch(x);
+                FIRE_ON_VALUE_CHANGED(x);
+            }
+            else
+                move_to_bound(x, v);
+        }
+        return true;
+    }
+    bool solver::set_ub(const utils::var x, const utils::inf_rational &v, std::optional<std::reference_wrapper<constraint>> reason, const utils::rational &scale) noexcept
+    {
+        assert(x < vars.size());
+        assert(v < utils::rational::positive_infinite);
+        LOG_TRACE("x" << std::to_string(x) << " = " << utils::to_string(val(x)) << " [" << utils::to_string(lb(x)) << ", " << utils::to_string(v) << " <- " << utils::to_string(ub(x)) << "]");
+        TRACE_EVENT(upper_bound, x);
+        if (slacks[x] == slack_state::inactive)
+            reactivate(x);
+        if (v < lb(x))
+        { // inconsistent bound..
+            STAT_INC(n_conflicts);
+            new_conflict();
+            if (reason)
+                add_to_conflict(reason->get(), scale);
+            explain_lb(x, utils::rational::one); // we use the most restrictive lower bound of x
+            end_conflict();
+            return false;
+        }
+        if (reason)
+        { // we have a reason for this bound..
+            if (auto it = reason->get().ubs.find(x); it != reason->get().ubs.end())
+            { // we already have an upper bound for this variable in the reason..
+                if (it->second > v)
+                { // we update the upper bound only if the new one is more restrictive..
+                    vars.at(x).unset_ub(it->second, *reason);
+                    trail_bound(x, true, v, &reason->get(), true, it->second, reason->get().scale(x, true));
+                    it->second = v;
+                    reason->get().set_scale(x, true, scale);
+                }
+                else
+                    trail_bound(x, true, v, &reason->get());
+            }
+            else
+            {
+                trail_bound(x, true, v, &reason->get(), true);
+                reason->get().ubs.emplace(x, v);
+                reason->get().set_scale(x, true, scale);
+            }
+        }
+        else
+            trail_bound(x, true, v, nullptr);
+        vars.at(x).set_ub(v, reason);
+        invalidate_implied_bounds(x);
+        if (is_basic(x))
+            update_violation(x);
+        else if (val(x) > v)
+        {
+            if (slacks[x] == slack_state::difference)
+            { // the slack variable has no row to update, and its difference might imply a tighter bound, hence `check_differences` will resync it..
+                vars[x].val = v;
+                touch(x);
+                FIRE_ON_VALUE_CHANGED(x);
+            }
+            else
+                move_to_bound(x, v);
+        }
+        return true;
+    }
+
+    void solver::update(const utils::var x_i, const utils::inf_rational &v) noexcept
+    {
+        assert(x_i < vars.size());
+        assert(!is_basic(x_i));
+        assert(v >= lb(x_i) && v <= ub(x_i));
+        STAT_INC(n_updates);
+
+        // the tableau rows containing `x_i` as a non-basic variable..
+        const auto delta = sub(v, vars[x_i].val);
+        for (const auto &o : tableau->column(x_i))
+        { // x_j = x_j + a_ji(v - x_i)..
+            const auto x_j = tableau->basic(o);
+            LOG_TRACE("x" << std::to_string(x_j) << " = " << utils::to_string(val(x_j)) << " -> " << utils::to_string(add(val(x_j), mul(tableau->coeff(o), delta))) << " [" << utils::to_string(lb(x_j)) << ", " << utils::to_string(ub(x_j)) << "]");
+            add_mul(vars[x_j].val, tableau->coeff(o), delta);
+            touch(x_j);
+            update_violation(x_j);
+            FIRE_ON_VALUE_CHANGED(x_j);
+        }
+
+        LOG_TRACE("x" << std::to_string(x_i) << " = " << utils::to_string(val(x_i)) << " -> " << utils::to_string(v) << " [" << utils::to_string(lb(x_i)) << ", " << utils::to_string(ub(x_i)) << "]");
+        TRACE_EVENT(update, x_i);
+        vars[x_i].val = v;
+        touch(x_i);
+        FIRE_ON_VALUE_CHANGED(x_i);
+    }
+
+    void solver::pivot_and_update(const utils::var x_i, const utils::var x_j, const utils::inf_rational &v) noexcept
+    {
+        assert(x_i < vars.size());
+        assert(x_j < vars.size());
+        assert(is_basic(x_i));
+        assert(!is_basic(x_j));
+        assert(tableau->coeff(x_i, x_j));
+        assert(v >= vars[x_i].get_lb() && v <= vars[x_i].get_ub());
+
+        const auto theta = div(sub(v, val(x_i)), *tableau->coeff(x_i, x_j));
+        LOG_TRACE("x" << std::to_string(x_i) << " = " << utils::to_string(val(x_i)) << " -> " << utils::to_string(v) << " [" << utils::to_string(lb(x_i)) << ", " << utils::to_string(ub(x_i)) << "]");
+        // x_i = v
+        vars[x_i].val = v;
+        touch(x_i);
+        FIRE_ON_VALUE_CHANGED(x_i);
+        LOG_TRACE("x" << std::to_string(x_j) << " = " << utils::to_string(val(x_j)) << " -> " << utils::to_string(add(val(x_j), theta)) << " [" << utils::to_string(lb(x_j)) << ", " << utils::to_string(ub(x_j)) << "]");
+        // x_j += theta
+        vars[x_j].val = add(vars[x_j].val, theta); // `x_j` becomes basic, hence it might now violate its bounds..
+        touch(x_j);
+        FIRE_ON_VALUE_CHANGED(x_j);
+
+        // the tableau rows containing `x_j` as a non-basic variable..
+        for (const auto &o : tableau->column(x_j))
+            if (const auto x_k = tableau->basic(o); x_k != x_i)
+            { // x_k += a_kj * theta..
+                LOG_TRACE("x" << std::to_string(x_k) << " = " << utils::to_string(val(x_k)) << " -> " << utils::to_string(add(val(x_k), mul(tableau->coeff(o), theta))) << " [" << utils::to_string(lb(x_k)) << ", " << utils::to_string(ub(x_k)) << "]");
+                add_mul(vars[x_k].val, tableau->coeff(o), theta);
+                touch(x_k);
+                update_violation(x_k);
+                FIRE_ON_VALUE_CHANGED(x_k);
+            }
+
+        pivot(x_i, x_j);
+    }
+
+    void solver::pivot(const utils::var x_i, const utils::var x_j) noexcept
+    {
+        assert(x_i < vars.size());
+        assert(x_j < vars.size());
+        assert(is_basic(x_i));
+        assert(!is_basic(x_j));
+        assert(tableau->coeff(x_i, x_j));
+
+        STAT_INC(n_pivots);
+        STAT_TIMER(pivot_time);
+        TRACE_EVENT(pivot, x_i, x_j);
+        // we rewrite `x_i = ...` as `x_j = ...` and substitute `x_j` in the rows that contain it..
+        const auto touched = tableau.write().pivot(x_i, x_j);
+        STAT_ADD(n_touched_rows, touched.size());
+        for (const auto &r : touched)
+        {
+            [[maybe_unused]] const auto x_k = tableau->rows()[r].basic;
+            r_bounds[x_k].valid = false; // the row of `x_k` has been rewritten..
+            touch(x_k);
+            LOG_TRACE("x" << std::to_string(x_k) << " = " << utils::to_string(tableau->to_lin(x_k)));
+        }
+        violated.erase(x_i); // `x_i` is no longer a basic variable..
+        touch(x_i);
+
+        // we have a new row `x_j = ...`
+        LOG_TRACE("x" << std::to_string(x_j) << " = " << utils::to_string(tableau->to_lin(x_j)));
+        r_bounds[x_j].valid = false;
+        touch(x_j);
+        update_violation(x_j);
+    }
+
+    void solver::new_row(const utils::var x, utils::lin &&l) noexcept
+    {
+        assert(x < vars.size());
+        assert(!is_basic(x));
+        LOG_TRACE("x" << std::to_string(x) << " = " << utils::to_string(l));
+        tableau.write().add_row(x, l);
+        r_bounds[x].valid = false;
+        touch(x);
+        update_violation(x);
+    }
+
+    void solver::substitute_basic(utils::lin &expr) const noexcept
+    {
+        // we remove the basic variables from the expression and replace them with their corresponding linear expressions in the tableau
+        std::vector<std::pair<utils::var, utils::rational>> basics;
+        for (auto it = expr.vars.begin(); it != expr.vars.end();)
+            if (is_basic(it->first))
+            {
+                basics.emplace_back(it->first, it->second);
+                it = expr.vars.erase(it);
+            }
+            else
+                ++it;
+        for (const auto &[x, c] : basics)
+            for (const auto &t : tableau->terms(x))
+                if (auto [trm_it, added] = expr.vars.emplace(t.v, mul(c, t.c)); !added)
+                {
+                    trm_it->second = add_mul(trm_it->second, c, t.c);
+                    if (trm_it->second == 0) // the term cancels out..
+                        expr.vars.erase(trm_it);
+                }
+    }
+
+    const solver::implied_bounds_cache &solver::implied_bounds(const utils::var x) const noexcept
+    {
+        assert(is_basic(x));
+        auto &rb = r_bounds[x];
+        if (!rb.valid)
+        { // we compute the bounds implied by the row of `x` in a single pass, telling their own overflows apart..
+            const bool outer = std::exchange(arith_overflow, false);
+            rb.lb = utils::rational::zero;
+            rb.ub = utils::rational::zero;
+            for (const auto &[v, c, _] : tableau->terms(x))
+                if (is_positive(c))
+                {
+                    add_mul(rb.lb, c, vars[v].get_lb());
+                    add_mul(rb.ub, c, vars[v].get_ub());
+                }
+                else
+                {
+                    add_mul(rb.lb, c, vars[v].get_ub());
+                    add_mul(rb.ub, c, vars[v].get_lb());
+                }
+            rb.valid = true;
+            rb.overflow = arith_overflow;
+            arith_overflow = outer || rb.overflow;
+        }
+        return rb;
+    }
+    solver::implied_bounds_cache solver::difference_bounds(const utils::var x) const noexcept
+    {
+        assert(slacks[x] == slack_state::difference);
+        const auto &d = d_vars[x].d;
+        implied_bounds_cache db{utils::rational::zero, utils::rational::zero, true};
+        const bool outer = std::exchange(arith_overflow, false);
+        add_mul(db.lb, d.a, lb(d.x));
+        add_mul(db.lb, neg(d.a), ub(d.y));
+        add_mul(db.ub, d.a, ub(d.x));
+        add_mul(db.ub, neg(d.a), lb(d.y));
+        db.overflow = arith_overflow;
+        arith_overflow = outer || db.overflow;
+        return db;
+    }
+
+    void solver::invalidate_implied_bounds(const utils::var x) noexcept
+    {
+        assert(x < vars.size());
+        touch(x);
+        if (x < d_vars.size() && d_vars[x].r != difference_var::role::none)
+            update_difference_edges(x);
+        // the bounds of a non-basic variable contribute to the implied bounds of the rows watching it..
+        for (const auto &o : tableau->column(x))
+        {
+            r_bounds[tableau->basic(o)].valid = false;
+            touch(tableau->basic(o));
+        }
+    }
+
+    void solver::new_conflict() noexcept
+    {
+        cnfl.clear();
+        cnfl_coeffs.clear();
+        cnfl_idx.clear();
+    }
+
+    void solver::add_to_conflict(const constraint &c, const utils::rational &m) noexcept
+    {
+        if (const auto [it, added] = cnfl_idx.emplace(&c, cnfl.size()); added)
+        {
+            cnfl.push_back(c);
+            cnfl_coeffs.push_back(m);
+        }
+        else // the constraint is already part of the explanation..
+            cnfl_coeffs[it->second] = add(cnfl_coeffs[it->second], m);
+    }
+
+    void solver::end_conflict() noexcept
+    {
+        // the multipliers of the constraints whose bounds are used in opposite directions might cancel out..
+        std::size_t n = 0;
+        for (std::size_t i = 0; i < cnfl.size(); ++i)
+            if (!is_zero(cnfl_coeffs[i]))
+            {
+                cnfl[n] = cnfl[i];
+                cnfl_coeffs[n] = cnfl_coeffs[i];
+                ++n;
+            }
+        cnfl.erase(cnfl.begin() + n, cnfl.end());
+        cnfl_coeffs.erase(cnfl_coeffs.begin() + n, cnfl_coeffs.end());
+        cnfl_idx.clear();
+        if (c_minimize && cnfl.size() > 1)
+            minimize_conflict();
+        TRACE_EVENT(conflict, cnfl.size());
+    }
+
+    void solver::minimize_conflict() noexcept
+    {
+        // we try to remove first the constraints with the smallest multipliers, which are the least likely to be necessary..
+        std::vector<std::size_t> order(cnfl.size());
+        for (std::size_t i = 0; i < order.size(); ++i)
+            order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [this](const std::size_t a, const std::size_t b)
+                         { return (is_negative(cnfl_coeffs[a]) ? neg(cnfl_coeffs[a]) : cnfl_coeffs[a]) < (is_negative(cnfl_coeffs[b]) ? neg(cnfl_coeffs[b]) : cnfl_coeffs[b]); });
+        // the variables reachable from the bounds of the constraints, through the rows linking basic and non-basic variables..
+        std::vector<bool> reached(vars.size(), false);
+        std::vector<utils::var> queue;
+        const auto reach = [&reached, &queue](const utils::var x)
+        {
+            if (!reached[x])
+            {
+                reached[x] = true;
+                queue.push_back(x);
+            }
+        };
+        for (const auto &c : cnfl)
+            for (const auto *bs : {&c.get().lbs, &c.get().ubs})
+                for (const auto &[x, v] : *bs)
+                    reach(x);
+        for (std::size_t head = 0; head < queue.size(); ++head)
+            if (const auto x = queue[head]; is_basic(x))
+                for (const auto &[v, c, _] : tableau->terms(x))
+                    reach(v);
+            else if (slacks[x] == slack_state::difference)
+            { // the slack variable has no row, but its difference..
+                reach(d_vars[x].d.x);
+                reach(d_vars[x].d.y);
+            }
+            else
+                for (const auto &o : tableau->column(x))
+                    reach(tableau->basic(o));
+        std::sort(queue.begin(), queue.end());
+
+        // the bounds without reason hold regardless of the constraints, hence those on the reachable variables are part of every test..
+        std::vector<std::tuple<utils::var, bool, utils::inf_rational>> facts;
+        for (const auto x : queue)
+        {
+            for (auto it = vars[x].lbs.crbegin(); it != vars[x].lbs.crend(); ++it)
+                if (!it->reason)
+                {
+                    facts.emplace_back(x, false, it->v);
+                    break;
+                }
+            for (auto it = vars[x].ubs.crbegin(); it != vars[x].ubs.crend(); ++it)
+                if (!it->reason)
+                {
+                    facts.emplace_back(x, true, it->v);
+                    break;
+                }
+        }
+
+        std::vector<bool> kept(cnfl.size(), true);
+        std::vector<const constraint *> cs;
+        std::vector<constraint> s_cs;
+        for (const auto i : order)
+        { // we check whether the explanation without the `i`-th constraint is still inconsistent..
+            kept[i] = false;
+            cs.clear();
+            for (std::size_t j = 0; j < cnfl.size(); ++j)
+                if (kept[j])
+                    cs.push_back(&cnfl[j].get());
+            solver s;
+            if (!inconsistent(facts, cs, s, s_cs))
+                kept[i] = true; // the `i`-th constraint is necessary..
+        }
+
+        // we recompute the multipliers on the irreducible explanation..
+        cs.clear();
+        for (std::size_t j = 0; j < cnfl.size(); ++j)
+            if (kept[j])
+                cs.push_back(&cnfl[j].get());
+        solver s;
+        if (!inconsistent(facts, cs, s, s_cs) || s.cnfl.empty())
+            return; // should never happen, but we keep the original explanation, just in case..
+        new_conflict();
+        for (std::size_t k = 0; k < s.cnfl.size(); ++k)
+        {
+            const auto i = static_cast<std::size_t>(&s.cnfl[k].get() - s_cs.data());
+            add_to_conflict(*cs[i], s.cnfl_coeffs[k]); // the bounds of `s` are scaled, so that the multipliers refer to the constraints as written..
+        }
+        cnfl_idx.clear();
+    }
+
+    bool solver::inconsistent(const std::vector<std::tuple<utils::var, bool, utils::inf_rational>> &facts, const std::vector<const constraint *> &cs, solver &s, std::vector<constraint> &s_cs) const noexcept
+    {
+        s_cs.assign(cs.size(), constraint()); // the constraints are referenced by address, hence they are created all at once..
+        std::unordered_map<utils::var, utils::var> s_vars; // the non-basic variables of this solver mirrored into `s`..
+        // returns the variable of `s` and the coefficient `c` such that `x` is `c` times the variable..
+        const auto to_s = [this, &s, &s_vars](const utils::var x)
+        {
+            utils::lin l;
+            if (is_basic(x))
+                l = tableau->to_lin(x);
+            else if (slacks[x] == slack_state::difference)
+            { // the slack variable has no row, hence we mirror its difference..
+                l = to_lin(d_vars[x].d);
+                substitute_basic(l);
+            }
+            else
+                l.vars.emplace(x, utils::rational::one);
+            utils::lin s_l;
+            for (const auto &[v, c] : l.vars)
+            {
+                auto it = s_vars.find(v);
+                if (it == s_vars.end())
+                    it = s_vars.emplace(v, s.new_var()).first;
+                s_l.vars.emplace(it->second, c);
+            }
+            if (s_l.vars.size() == 1) // we bound the variable directly, scaling the bound by the coefficient..
+                return std::make_pair(s_l.vars.begin()->first, s_l.vars.begin()->second);
+            return std::make_pair(s.new_var(std::move(s_l)), utils::rational::one);
+        };
+        const bool conflict = [&]
+        {
+            const overflow_scope scope(s.a_overflow); // the overflows of the mirroring belong to the scratch solver..
+            for (const auto &[x, upper, v] : facts)
+            {
+                const auto [y, c] = to_s(x);
+                if (!(upper == is_positive(c) ? s.set_ub(y, div(v, c), std::nullopt) : s.set_lb(y, div(v, c), std::nullopt)))
+                    return true;
+            }
+            for (std::size_t i = 0; i < cs.size(); ++i)
+            {
+                for (const auto &[x, v] : cs[i]->lbs)
+                { // `x >= v` becomes `c * y >= v`, whose multipliers are divided by `c` for referring to `x`..
+                    const auto [y, c] = to_s(x);
+                    const auto sc = div(cs[i]->scale(x, false), c);
+                    if (!(is_positive(c) ? s.set_lb(y, div(v, c), s_cs[i], sc) : s.set_ub(y, div(v, c), s_cs[i], sc)))
+                        return true; // the bounds are already inconsistent..
+                }
+                for (const auto &[x, v] : cs[i]->ubs)
+                { // `x <= v` becomes `c * y <= v`, whose multipliers are divided by `c` for referring to `x`..
+                    const auto [y, c] = to_s(x);
+                    const auto sc = div(cs[i]->scale(x, true), c);
+                    if (!(is_positive(c) ? s.set_ub(y, div(v, c), s_cs[i], sc) : s.set_lb(y, div(v, c), s_cs[i], sc)))
+                        return true; // the bounds are already inconsistent..
+                }
+            }
+            return false;
+        }();
+        if (s.a_overflow) // an overflow proves nothing, hence the constraint is kept..
+            return false;
+        return conflict || s.check(check_budget()) == check_result::unsat;
+    }
+
+    void solver::explain_lb(const utils::var x, const utils::rational &m) noexcept
+    {
+        if (is_basic(x) && lb(x) > vars[x].get_lb())
+            explain_implied_lb(x, m); // the lower bound of `x` is implied by its row..
+        else if (slacks[x] == slack_state::difference && lb(x) > vars[x].get_lb())
+        { // the lower bound of `x` is implied by its difference..
+            explain_lb(d_vars[x].d.x, mul(m, d_vars[x].d.a));
+            explain_ub(d_vars[x].d.y, mul(m, d_vars[x].d.a));
+        }
+        else if (const auto r = vars[x].bound_reason(false); r) // any of the reasons of the bound is enough, hence we pick the oldest one..
+            add_to_conflict(*r, neg(mul(m, r->scale(x, false))));
+    }
+    void solver::explain_ub(const utils::var x, const utils::rational &m) noexcept
+    {
+        if (is_basic(x) && ub(x) < vars[x].get_ub())
+            explain_implied_ub(x, m); // the upper bound of `x` is implied by its row..
+        else if (slacks[x] == slack_state::difference && ub(x) < vars[x].get_ub())
+        { // the upper bound of `x` is implied by its difference..
+            explain_ub(d_vars[x].d.x, mul(m, d_vars[x].d.a));
+            explain_lb(d_vars[x].d.y, mul(m, d_vars[x].d.a));
+        }
+        else if (const auto r = vars[x].bound_reason(true); r) // any of the reasons of the bound is enough, hence we pick the oldest one..
+            add_to_conflict(*r, mul(m, r->scale(x, true)));
+    }
+    void solver::explain_implied_lb(const utils::var x, const utils::rational &m) noexcept
+    {
+        for (const auto &[v, c, _] : tableau->terms(x))
+            if (is_positive(c)) // we use the most restrictive lower bound of v
+                explain_lb(v, mul(m, c));
+            else if (is_negative(c)) // we use the most restrictive upper bound of v
+                explain_ub(v, neg(mul(m, c)));
+    }
+    void solver::explain_implied_ub(const utils::var x, const utils::rational &m) noexcept
+    {
+        for (const auto &[v, c, _] : tableau->terms(x))
+            if (is_positive(c)) // we use the most restrictive upper bound of v
+                explain_ub(v, mul(m, c));
+            else if (is_negative(c)) // we use the most restrictive lower bound of v
+                explain_lb(v, neg(mul(m, c)));
+    }
+
+    void solver::update_violation(const utils::var x) noexcept
+    {
+        assert(x < vars.size());
+        // non-basic variables are always kept within their bounds, hence only basic variables can be violated..
+        if (is_basic(x) && (vars[x].val < vars[x].get_lb() || vars[x].val > vars[x].get_ub()))
+            violated.insert(x);
+        else
+            violated.erase(x);
+    }
+
+#ifdef LINSPIRE_ENABLE_LISTENERS
+    void solver::set_deferred_notifications(const bool enable) noexcept
+    {
+        deferred = enable;
+        if (!deferred)
+            flush_notifications();
+    }
+
+    void solver::flush_notifications() noexcept
+    {
+        // we collect, for each listener, the changed variables it listens to..
+        std::vector<listener *> to_notify;
+        for (const auto &x : dirty)
+        {
+            listening[x].dirty = false;
+            for (auto &l : listening[x].ls)
+            {
+                if (l->changed.empty())
+                    to_notify.push_back(l);
+                l->changed.push_back(x);
+            }
+        }
+        dirty.clear();
+        for (auto &l : to_notify)
+        {
+            l->on_values_changed(l->changed);
+            l->changed.clear();
+        }
+    }
+
+    void solver::fire_on_value_changed(const utils::var x) noexcept
+    {
+        if (x >= listening.size() || listening[x].ls.empty())
+            return; // nobody is listening to `x`..
+        if (deferred)
+        { // we just mark the variable, the listeners will be notified at the end of the `check` procedure..
+            if (!listening[x].dirty)
+            {
+                listening[x].dirty = true;
+                dirty.push_back(x);
+            }
+        }
+        else
+            for (auto &l : listening[x].ls)
+                l->on_value_changed(x);
+    }
+#endif
+
+#ifdef LINSPIRE_ENABLE_STATISTICS
+    statistics solver::stats() const noexcept
+    {
+        statistics s = c_stats;
+        std::size_t n_terms = 0;
+        for (const auto &r : tableau->rows())
+        {
+            n_terms += r.terms.size();
+            s.max_row_length = std::max(s.max_row_length, r.terms.size());
+        }
+        s.avg_row_length = tableau->size() ? static_cast<double>(n_terms) / static_cast<double>(tableau->size()) : 0;
+        return s;
+    }
+#endif
+
+    std::string to_string(const solver &s) noexcept
+    {
+        std::string str;
+        for (utils::var i = 0; i < s.vars.size(); ++i)
+            str += "x" + std::to_string(i) + " = " + to_string(s.vars.at(i)) + "\n";
+        for (utils::var i = 0; i < s.vars.size(); ++i)
+            if (s.is_basic(i))
+                str += "x" + std::to_string(i) + " = " + utils::to_string(s.tableau->to_lin(i)) + "\n";
+        return str;
+    }
+
+    json::json to_json(const solver &s) noexcept
+    {
+        json::json j;
+        json::json j_vars;
+        for (utils::var i = 0; i < s.vars.size(); ++i)
+            j_vars["x" + std::to_string(i)] = to_json(s.vars.at(i));
+        j["vars"] = j_vars;
+        json::json j_tableau;
+        for (const auto &r : s.tableau->rows())
+            j_tableau["x" + std::to_string(r.basic)] = to_json(s.tableau->to_lin(r.basic));
+        j["tableau"] = j_tableau;
+        j["memory"] = to_json(s.memory_usage());
+        return j;
+    }
+
+    json::json to_json(const utils::rational &r) noexcept { return json::json{{"num", r.numerator()}, {"den", r.denominator()}}; }
+
+    json::json to_json(const utils::inf_rational &r) noexcept
+    {
+        json::json j = to_json(r.get_rational());
         if (!is_zero(r.get_infinitesimal()))
             j["inf"] = to_json(r.get_infinitesimal());
         return j;
     }
 
+#ifdef LINSPIRE_ENABLE_STATISTICS
+    json::json to_json(const statistics &s) noexcept
+    {
+        json::json j;
+        j["checks"] = static_cast<long long>(s.n_checks);
+        j["pivots"] = static_cast<long long>(s.n_pivots);
+        j["updates"] = static_cast<long long>(s.n_updates);
+        j["touched_rows"] = static_cast<long long>(s.n_touched_rows);
+        j["avg_touched_rows"] = s.n_pivots ? static_cast<double>(s.n_touched_rows) / static_cast<double>(s.n_pivots) : 0.0;
+        j["conflicts"] = static_cast<long long>(s.n_conflicts);
+        j["reused_slacks"] = static_cast<long long>(s.n_reused_slacks);
+        j["max_row_length"] = static_cast<long long>(s.max_row_length);
+        j["avg_row_length"] = s.avg_row_length;
+        j["check_time_ns"] = static_cast<long long>(s.check_time.count());
+        j["pivot_time_ns"] = static_cast<long long>(s.pivot_time.count());
+        return j;
+    }
+#endif
+
+    json::json to_json(const memory_report &r) noexcept
+    {
+        json::json j;
+        j["vars"] = static_cast<long long>(r.vars);
+        j["tableau"] = static_cast<long long>(r.tableau);
+        j["exprs"] = static_cast<long long>(r.exprs);
+        j["trail"] = static_cast<long long>(r.trail);
+        j["conflicts"] = static_cast<long long>(r.conflicts);
+        j["differences"] = static_cast<long long>(r.differences);
+        j["listeners"] = static_cast<long long>(r.listeners);
+        j["other"] = static_cast<long long>(r.other);
+        j["shared"] = static_cast<long long>(r.shared);
+        j["total"] = static_cast<long long>(r.total());
+        json::json j_density;
+        for (std::size_t i = 0; i < r.row_density.size(); ++i)
+            j_density[std::to_string(std::size_t(1) << i)] = static_cast<long long>(r.row_density[i]);
+        j["row_density"] = j_density;
+        return j;
+    }
+
     json::json to_json(const utils::lin &l) noexcept
     {
         json::json j;
@@ -0,0 +1,29 @@
+#include "snapshot.hpp"
+#include "arith.hpp"
+
+namespace linspire
+{
+    utils::inf_rational solver_snapshot::lb(const utils::lin &l) const noexcept
+    {
+        utils::inf_rational b(l.known_term);
+        for (const auto &[v, c] : l.vars)
+            add_mul(b, c, is_positive(c) ? lb(v) : ub(v));
+        return b;
+    }
+    utils::inf_rational solver_snapshot::ub(const utils::lin &l) const noexcept
+    {
+        utils::inf_rational b(l.known_term);
+        for (const auto &[v, c] : l.vars)
+            add_mul(b, c, is_positive(c) ? ub(v) : lb(v));
+        return b;
+    }
+    utils::inf_rational solver_snapshot::val(const utils::lin &l) const noexcept
+    {
+        utils::inf_rational v(l.known_term);
+        for (const auto &[x, c] : l.vars)
+            add_mul(v, c, val(x));
+        return v;
+    }
+
+    bool solver_snapshot::match(const utils::lin &l0, const utils::lin &l1) const noexcept { return lb(l0) <= ub(l1) && ub(l0) >= lb(l1); }
+} // namespace linspire
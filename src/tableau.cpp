@@ -0,0 +1,205 @@
+#include "tableau.hpp"
+#include "arith.hpp"
+#include <algorithm>
+#include <cassert>
+
+namespace linspire
+{
+    template <typename T>
+    void basic_tableau<T>::pop_var() noexcept
+    {
+        assert(!row_of.empty());
+        assert(row_of.back() == npos);
+        assert(columns.back().empty());
+        row_of.pop_back();
+        columns.pop_back();
+    }
+
+    template <typename T>
+    const T *basic_tableau<T>::coeff(const utils::var x, const utils::var v) const noexcept
+    {
+        assert(is_basic(x));
+        const auto &ts = t_rows[row_of[x]].terms;
+        const auto it = std::lower_bound(ts.cbegin(), ts.cend(), v, [](const term &t, const utils::var w)
+                                         { return t.v < w; });
+        return it != ts.cend() && it->v == v ? &it->c : nullptr;
+    }
+
+    template <>
+    void basic_tableau<utils::rational>::add_row(const utils::var x, const utils::lin &l) noexcept
+    {
+        assert(!is_basic(x));
+        assert(columns[x].empty());
+        const auto r = t_rows.size();
+        row_of[x] = r;
+        auto &rw = t_rows.emplace_back();
+        rw.basic = x;
+        rw.terms.reserve(l.vars.size());
+        for (const auto &[v, c] : l.vars) // the terms of `l` are already sorted by variable..
+        {
+            assert(!is_basic(v));
+            rw.terms.push_back({v, c, columns[v].size()});
+            columns[v].push_back({r, rw.terms.size() - 1});
+        }
+    }
+
+    template <typename T>
+    void basic_tableau<T>::remove_row(const utils::var x) noexcept
+    {
+        assert(is_basic(x));
+        const auto r = row_of[x];
+        for (const auto &t : t_rows[r].terms)
+            remove_occurrence(t.v, t.col_pos);
+        row_of[x] = npos;
+        if (r != t_rows.size() - 1)
+        { // we move the last row in place of the removed one..
+            t_rows[r] = std::move(t_rows.back());
+            row_of[t_rows[r].basic] = r;
+            reindex(r);
+        }
+        t_rows.pop_back();
+    }
+
+    template <typename T>
+    const std::vector<std::size_t> &basic_tableau<T>::pivot(const utils::var x_i, const utils::var x_j) noexcept
+    {
+        assert(is_basic(x_i));
+        assert(!is_basic(x_j));
+        assert(columns[x_i].empty());
+        const auto r = row_of[x_i];
+
+        // we rewrite `x_i = ... + cc * x_j + ...` as `x_j = ... + (1 / cc) * x_i + ...`
+        auto &x_j_terms = scratch_terms; // the buffers are swapped with the rewritten rows, so that their memory is reused..
+        x_j_terms.clear();
+        x_j_terms.reserve(t_rows[r].terms.size());
+        const auto x_j_c = coeff(x_i, x_j);
+        assert(x_j_c);
+        const T cc = *x_j_c;
+        const T neg_cc = neg(cc);
+        bool x_i_added = false;
+        for (const auto &t : t_rows[r].terms)
+        {
+            if (t.v == x_j) // `x_j` becomes basic, hence its occurrences are removed all at once below..
+                continue;
+            if (!x_i_added && x_i < t.v)
+            {
+                x_j_terms.push_back({x_i, div(T(1), cc), columns[x_i].size()});
+                columns[x_i].push_back({r, 0});
+                x_i_added = true;
+            }
+            x_j_terms.push_back({t.v, div(t.c, neg_cc), t.col_pos});
+        }
+        if (!x_i_added)
+        {
+            x_j_terms.push_back({x_i, div(T(1), cc), columns[x_i].size()});
+            columns[x_i].push_back({r, 0});
+        }
+        t_rows[r].basic = x_j;
+        std::swap(t_rows[r].terms, x_j_terms);
+        row_of[x_j] = r;
+        row_of[x_i] = npos;
+        reindex(r);
+
+        // we substitute `x_j` in the other rows containing it..
+        touched.clear();
+        std::swap(scratch_occs, columns[x_j]);
+        columns[x_j].clear();
+        const auto &src = t_rows[r].terms;
+        for (const auto &o : scratch_occs)
+        {
+            if (o.row == r)
+                continue;
+            touched.push_back(o.row);
+            auto &dst = t_rows[o.row].terms;
+            const T a = dst[o.pos].c; // the coefficient of `x_j` in the row..
+            auto &merged = scratch_terms;
+            merged.clear();
+            merged.reserve(dst.size() + src.size());
+            scratch_removed.clear();
+            auto d_it = dst.cbegin();
+            auto s_it = src.cbegin();
+            while (d_it != dst.cend() || s_it != src.cend())
+                if (d_it != dst.cend() && d_it->v == x_j)
+                    ++d_it;
+                else if (s_it == src.cend() || (d_it != dst.cend() && d_it->v < s_it->v))
+                    merged.push_back(*d_it++);
+                else if (d_it == dst.cend() || s_it->v < d_it->v)
+                { // `v` is not in the row, so we add it..
+                    merged.push_back({s_it->v, mul(s_it->c, a), npos});
+                    ++s_it;
+                }
+                else
+                { // `v` is in both rows, so we sum the coefficients..
+                    auto c = add_mul(d_it->c, s_it->c, a);
+                    if (is_negligible(c)) // the term cancels out..
+                        scratch_removed.emplace_back(d_it->v, d_it->col_pos);
+                    else
+                        merged.push_back({d_it->v, std::move(c), d_it->col_pos});
+                    ++d_it;
+                    ++s_it;
+                }
+            std::swap(dst, merged);
+            for (std::size_t i = 0; i < dst.size(); ++i)
+                if (dst[i].col_pos == npos)
+                { // we add the new occurrence..
+                    dst[i].col_pos = columns[dst[i].v].size();
+                    columns[dst[i].v].push_back({o.row, i});
+                }
+                else
+                    columns[dst[i].v][dst[i].col_pos] = {o.row, i};
+            for (const auto &[v, col_pos] : scratch_removed)
+                remove_occurrence(v, col_pos);
+        }
+        return touched;
+    }
+
+    template <typename T>
+    void basic_tableau<T>::compact() noexcept
+    {
+        t_rows.shrink_to_fit();
+        for (auto &r : t_rows)
+            r.terms.shrink_to_fit();
+        row_of.shrink_to_fit();
+        columns.shrink_to_fit();
+        for (auto &col : columns)
+            col.shrink_to_fit();
+        scratch_terms = std::vector<term>();
+        scratch_occs = std::vector<occurrence>();
+        scratch_removed = std::vector<std::pair<utils::var, std::size_t>>();
+        touched = std::vector<std::size_t>();
+    }
+
+    template <>
+    utils::lin basic_tableau<utils::rational>::to_lin(const utils::var x) const noexcept
+    {
+        assert(is_basic(x));
+        utils::lin l;
+        for (const auto &t : t_rows[row_of[x]].terms)
+            l.vars.emplace_hint(l.vars.cend(), t.v, t.c);
+        return l;
+    }
+
+    template <typename T>
+    void basic_tableau<T>::remove_occurrence(const utils::var v, const std::size_t col_pos) noexcept
+    {
+        auto &col = columns[v];
+        assert(col_pos < col.size());
+        if (col_pos != col.size() - 1)
+        { // we move the last occurrence in place of the removed one..
+            col[col_pos] = col.back();
+            t_rows[col[col_pos].row].terms[col[col_pos].pos].col_pos = col_pos;
+        }
+        col.pop_back();
+    }
+
+    template <typename T>
+    void basic_tableau<T>::reindex(const std::size_t r) noexcept
+    {
+        const auto &ts = t_rows[r].terms;
+        for (std::size_t i = 0; i < ts.size(); ++i)
+            columns[ts[i].v][ts[i].col_pos] = {r, i};
+    }
+
+    template class basic_tableau<utils::rational>;
+    template class basic_tableau<double>;
+} // namespace linspire
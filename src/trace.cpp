@@ -0,0 +1,79 @@
+#include "trace.hpp"
+
+namespace linspire
+{
+    void trace_buffer::set_capacity(const std::size_t capacity) noexcept
+    {
+        std::size_t c = 1;
+        while (c < capacity)
+            c <<= 1;
+        events.assign(c, trace_event{});
+        mask = c - 1;
+        n_recorded = 0;
+    }
+
+    std::vector<trace_event> trace_buffer::get_events() const noexcept
+    {
+        std::vector<trace_event> es;
+        es.reserve(size());
+        for (auto i = n_recorded - size(); i < n_recorded; ++i)
+            es.push_back(events[i & mask]);
+        return es;
+    }
+
+    void trace_buffer::dump(std::ostream &os) const noexcept
+    {
+        const auto write = [&os](const std::uint64_t v)
+        { os.write(reinterpret_cast<const char *>(&v), sizeof(v)); };
+        os.write("LSTRACE1", 8);
+        write(size());
+        for (auto i = n_recorded - size(); i < n_recorded; ++i)
+        {
+            const auto &e = events[i & mask];
+            write(e.time);
+            write(e.x);
+            write(e.y);
+            os.put(static_cast<char>(e.k));
+        }
+    }
+
+    std::string to_string(const trace_event::kind k) noexcept
+    {
+        switch (k)
+        {
+        case trace_event::kind::pivot:
+            return "pivot";
+        case trace_event::kind::lower_bound:
+            return "lower_bound";
+        case trace_event::kind::upper_bound:
+            return "upper_bound";
+        case trace_event::kind::update:
+            return "update";
+        case trace_event::kind::conflict:
+            return "conflict";
+        }
+        return "unknown";
+    }
+
+    json::json to_json(const trace_event &e) noexcept
+    {
+        json::json j;
+        j["kind"] = to_string(e.k);
+        j["time_ns"] = static_cast<long long>(e.time);
+        j["x"] = static_cast<long long>(e.x);
+        if (e.y != trace_event::none)
+            j["y"] = static_cast<long long>(e.y);
+        return j;
+    }
+
+    json::json to_json(const trace_buffer &b) noexcept
+    {
+        json::json j;
+        j["recorded"] = static_cast<long long>(b.recorded());
+        json::json j_events(json::json_type::array);
+        for (const auto &e : b.get_events())
+            j_events.push_back(to_json(e));
+        j["events"] = j_events;
+        return j;
+    }
+} // namespace linspire
@@ -1,64 +1,125 @@
 #include "var.hpp"
 #include "linspire.hpp"
+#include <algorithm>
 #include <cassert>
 
 namespace linspire
 {
-    var::var(const utils::inf_rational &lb, const utils::inf_rational &ub) noexcept { assert(lb < ub); }
+    var::var(const utils::inf_rational &lb, const utils::inf_rational &ub) noexcept : lb(utils::rational::negative_infinite), ub(utils::rational::positive_infinite) { assert(lb < ub); }
 
-    utils::inf_rational var::get_lb() const noexcept { return lbs.empty() ? utils::rational::negative_infinite : lbs.rbegin()->first; }
-    utils::inf_rational var::get_ub() const noexcept { return ubs.empty() ? utils::rational::positive_infinite : ubs.begin()->first; }
+    /**
+     * @brief Checks whether the (lower or upper) bound `a` is less restrictive than `b`.
+     */
+    static bool looser(const bool upper, const utils::inf_rational &a, const utils::inf_rational &b) noexcept { return upper ? b < a : a < b; }
 
     void var::set_lb(const utils::inf_rational &v, std::optional<std::reference_wrapper<const constraint>> reason) noexcept
     {
         assert(v <= get_ub()); // we cannot set a lower bound greater than the current upper bound..
-        if (reason)
-        { // we add a new lower bound `v` with the given reason..
-            if (auto it = lbs.find(v); it != lbs.end())
-                it->second.insert(&reason->get()); // we add the reason to the existing lower bound `v`..
-            else
-                lbs.emplace(v, std::set<const constraint *>{&reason->get()}); // we create a new lower bound `v`..
-        }
+        if (reason) // we add a new lower bound `v` with the given reason..
+            add_bound(lbs, false, v, &reason->get());
         else
         { // we remove all the lower bounds that are less than `v`..
-            auto it = lbs.upper_bound(v);
+            const auto it = std::upper_bound(lbs.begin(), lbs.end(), v, [](const utils::inf_rational &w, const bound &b)
+                                             { return w < b.v; });
             lbs.erase(lbs.begin(), it);
-            lbs.emplace(v, std::set<const constraint *>());
+            lbs.insert(lbs.begin(), {v, nullptr});
         }
+        refresh();
     }
     void var::unset_lb(const utils::inf_rational &v, const constraint &reason) noexcept
     {
-        assert(lbs.find(v) != lbs.end());
-        auto it = lbs.find(v);
-        it->second.erase(&reason);
-        if (it->second.empty())
-            lbs.erase(it);
+        remove_bound(lbs, false, v, &reason);
+        refresh();
     }
 
     void var::set_ub(const utils::inf_rational &v, std::optional<std::reference_wrapper<const constraint>> reason) noexcept
     {
         assert(v >= get_lb()); // we cannot set an upper bound less than the current lower bound..
-        if (reason)
-        { // we add a new upper bound `v` with the given reason..
-            if (auto it = ubs.find(v); it != ubs.end())
-                it->second.insert(&reason->get()); // we add the reason to the existing upper bound `v`..
-            else
-                ubs.emplace(v, std::set<const constraint *>{&reason->get()}); // we create a new upper bound `v`..
-        }
+        if (reason) // we add a new upper bound `v` with the given reason..
+            add_bound(ubs, true, v, &reason->get());
         else
         { // we remove all the upper bounds that are greater than `v`..
-            auto it = ubs.lower_bound(v);
-            ubs.erase(it, ubs.end());
-            ubs.emplace(v, std::set<const constraint *>());
+            const auto it = std::upper_bound(ubs.begin(), ubs.end(), v, [](const utils::inf_rational &w, const bound &b)
+                                             { return b.v < w; });
+            ubs.erase(ubs.begin(), it);
+            ubs.insert(ubs.begin(), {v, nullptr});
         }
+        refresh();
     }
     void var::unset_ub(const utils::inf_rational &v, const constraint &reason) noexcept
     {
-        assert(ubs.find(v) != ubs.end());
-        auto it = ubs.find(v);
-        it->second.erase(&reason);
-        if (it->second.empty())
-            ubs.erase(it);
+        remove_bound(ubs, true, v, &reason);
+        refresh();
+    }
+
+    const constraint *var::bound_reason(const bool upper) const noexcept
+    {
+        const auto &bs = upper ? ubs : lbs;
+        const auto &b = upper ? ub : lb;
+        const constraint *r = nullptr;
+        for (auto it = bs.crbegin(); it != bs.crend() && it->v == b; ++it)
+            if (!it->reason)
+                return nullptr; // the bound holds regardless of any constraint..
+            else
+                r = it->reason;
+        return r;
+    }
+
+    bool var::has_reason(const bool upper, const utils::inf_rational &v, const constraint &reason) const noexcept
+    {
+        const auto &bs = upper ? ubs : lbs;
+        for (auto it = std::lower_bound(bs.cbegin(), bs.cend(), v, [upper](const bound &b, const utils::inf_rational &w)
+                                        { return looser(upper, b.v, w); });
+             it != bs.cend() && it->v == v; ++it)
+            if (it->reason == &reason)
+                return true;
+        return false;
+    }
+
+    void var::restore_bounds(const bool upper, const utils::inf_rational &v, const bound_stack &erased) noexcept
+    {
+        auto &bs = upper ? ubs : lbs;
+        const auto first = std::lower_bound(bs.begin(), bs.end(), v, [upper](const bound &b, const utils::inf_rational &w)
+                                            { return looser(upper, b.v, w); });
+        auto last = first;
+        while (last != bs.end() && last->v == v)
+            ++last;
+        bs.erase(first, last);
+        for (const auto &b : erased)
+            add_bound(bs, upper, b.v, b.reason);
+        refresh();
+    }
+
+    void var::add_bound(bound_stack &bs, const bool upper, const utils::inf_rational &v, const constraint *reason) noexcept
+    {
+        // the reasons of the same bound are adjacent, hence we look for `reason` among them..
+        auto it = std::lower_bound(bs.begin(), bs.end(), v, [upper](const bound &b, const utils::inf_rational &w)
+                                   { return looser(upper, b.v, w); });
+        for (; it != bs.end() && it->v == v; ++it)
+            if (it->reason == reason)
+                return; // the reason is already there..
+        bs.insert(it, {v, reason});
+    }
+
+    void var::remove_bound(bound_stack &bs, const bool upper, const utils::inf_rational &v, const constraint *reason) noexcept
+    {
+        if (!bs.empty() && bs.back().v == v && bs.back().reason == reason)
+        { // the most restrictive bound is usually the one which is removed..
+            bs.pop_back();
+            return;
+        }
+        auto it = std::lower_bound(bs.begin(), bs.end(), v, [upper](const bound &b, const utils::inf_rational &w)
+                                   { return looser(upper, b.v, w); });
+        while (it != bs.end() && it->v == v && it->reason != reason)
+            ++it;
+        assert(it != bs.end() && it->v == v);
+        bs.erase(it);
+    }
+
+    void var::refresh() noexcept
+    {
+        lb = lbs.empty() ? utils::inf_rational(utils::rational::negative_infinite) : lbs.back().v;
+        ub = ubs.empty() ? utils::inf_rational(utils::rational::positive_infinite) : ubs.back().v;
     }
 
     std::string to_string(const var &x) noexcept { return utils::to_string(x.val) + " [" + utils::to_string(x.get_lb()) + ", " + utils::to_string(x.get_ub()) + "]"; }
@@ -67,9 +128,9 @@ namespace linspire
     {
         json::json j = to_json(x.val);
         if (!x.lbs.empty())
-            j["lb"] = to_json(x.lbs.rbegin()->first);
+            j["lb"] = to_json(x.lb);
         if (!x.ubs.empty())
-            j["ub"] = to_json(x.ubs.begin()->first);
+            j["ub"] = to_json(x.ub);
         return j;
     }
 } // namespace linspire
@@ -1,6 +1,13 @@
 #include "linspire.hpp"
+#include "arith.hpp"
 #include "logging.hpp"
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <random>
+#include <sstream>
 
 /**
  * @brief Unit test for the linspire::solver class.
@@ -171,9 +178,7 @@ void test_conflict_explanation_generation()
 
     // x + y <= 0
     bool res2 = s.new_lt({{x, 1}, {y, 1}}, 0, false, c2);
-    assert(res2);
-    cons = s.check();
-    assert(!cons);
+    assert(!res2); // `x + y` shares the slack variable of `-x - y`, hence its bounds clash right away..
     auto expl = s.get_conflict();
     assert(expl.size() == 2);
     assert((&expl[0].get() == &c0 && &expl[1].get() == &c2) || (&expl[0].get() == &c2 && &expl[1].get() == &c0));
@@ -181,6 +186,30 @@ void test_conflict_explanation_generation()
     s.retract(c0);
     cons = s.check();
     assert(cons);
+
+    // x + y >= 1, x <= 1 and y <= -1 clash through the row of `x + y`, hence only the check procedure detects it..
+    linspire::solver s1;
+    x = s1.new_var();
+    y = s1.new_var();
+    linspire::constraint c3, c4, c5;
+    bool res3 = s1.new_gt({{x, 1}, {y, 1}}, 1, false, c3);
+    assert(res3);
+    cons = s1.check();
+    assert(cons);
+    bool res4 = s1.new_lt({{x, 1}}, 1, false, c4);
+    assert(res4);
+    bool res5 = s1.new_lt({{y, 1}}, -1, false, c5);
+    assert(res5);
+    cons = s1.check();
+    assert(!cons);
+    auto expl1 = s1.get_conflict();
+    assert(expl1.size() == 3);
+    for (const auto &c : expl1)
+        assert(&c.get() == &c3 || &c.get() == &c4 || &c.get() == &c5);
+
+    s1.retract(c5);
+    cons = s1.check();
+    assert(cons);
 }
 
 /**
@@ -249,6 +278,90 @@ void test_slack_variable_reuse_for_duplicate_expression()
     assert(s.ub(slack1) == utils::rational::positive_infinite);
 }
 
+void test_normalized_expressions()
+{
+    linspire::solver s;
+    auto x = s.new_var();
+    auto y = s.new_var();
+
+    // 2x + 2y <= 4, x + y >= 1, -x - y >= -3, (1/2)x + (1/2)y < 3/2 and 3x + 3y == 3 all bound the slack variable of `x + y`..
+    linspire::constraint c0, c1;
+    bool res0 = s.new_lt({{x, 2}, {y, 2}}, 4, false, c0);
+    assert(res0);
+    const auto n_vars = s.snapshot().size();
+    bool res1 = s.new_gt({{x, 1}, {y, 1}}, 1, false, c1);
+    assert(res1);
+    bool res2 = s.new_gt({{x, -1}, {y, -1}}, -3);
+    assert(res2);
+    bool res3 = s.new_lt({{x, utils::rational(1, 2)}, {y, utils::rational(1, 2)}}, utils::rational(3, 2), true);
+    assert(res3);
+    assert(s.snapshot().size() == n_vars);
+    const utils::var sum = n_vars - 1;
+    assert(s.lb(sum) == 1);
+    assert(s.ub(sum) == 2);
+    assert(s.check());
+    assert(s.val(x) + s.val(y) >= 1);
+    assert(s.val(x) + s.val(y) <= 2);
+
+    // the bounds of the constraints are scaled, and keep being retracted independently..
+    s.retract(c0);
+    assert(s.ub(sum) < 3 && s.ub(sum) > utils::rational(5, 2));
+    bool res4 = s.new_eq({{x, 3}, {y, 3}}, 3);
+    assert(res4);
+    assert(s.snapshot().size() == n_vars);
+    assert(s.check());
+    assert(s.val(x) + s.val(y) == 1);
+
+    // x + y > 1 is now inconsistent..
+    bool res5 = s.new_gt({{x, 4}, {y, 4}}, 4, true);
+    assert(!res5);
+
+    // the coefficients of `x / 2^31 + 2^40 y` cannot be brought to machine integers, hence the expression is kept as it is..
+    const utils::rational tiny(1, std::int64_t(1) << 31), huge(std::int64_t(1) << 40);
+    linspire::solver s1;
+    auto x1 = s1.new_var();
+    auto y1 = s1.new_var();
+    bool res8 = s1.new_lt({{x1, tiny}, {y1, huge}}, 1);
+    assert(res8);
+    bool res9 = s1.new_gt({{x1, -tiny}, {y1, -huge}}, -2); // the same hyperplane, with the opposite sign..
+    assert(res9);
+    bool res10 = s1.new_gt({{x1, tiny}, {y1, huge}}, 2);
+    assert(!res10);
+
+    // the multipliers refer to the constraints as written: 1/2 * (2x + 2y) + 1/3 * (-3x - 3y) = 0, while 1/2 * 2 + 1/3 * -9 = -2 < 0
+    linspire::solver s2;
+    auto x2 = s2.new_var();
+    auto y2 = s2.new_var();
+    linspire::constraint c2, c3;
+    bool res6 = s2.new_lt({{x2, 2}, {y2, 2}}, 2, false, c2);
+    assert(res6);
+    bool res7 = s2.new_lt({{x2, -3}, {y2, -3}}, -9, false, c3);
+    assert(!res7);
+    const auto &cnfl = s2.get_conflict();
+    const auto &coeffs = s2.get_conflict_coefficients();
+    assert(cnfl.size() == 2);
+    for (std::size_t i = 0; i < cnfl.size(); ++i)
+        assert(coeffs[i] == (&cnfl[i].get() == &c2 ? utils::rational(1, 2) : utils::rational(1, 3)));
+
+    // the expressions are normalized once their basic variables are substituted: `z + y` becomes `2x + 2y`, hence it bounds the slack variable of `x + y`..
+    linspire::solver s3;
+    auto x3 = s3.new_var();
+    auto y3 = s3.new_var();
+    auto z3 = s3.new_var(utils::lin{{x3, 2}, {y3, 1}});
+    bool res11 = s3.new_lt({{x3, 1}, {y3, 1}}, 2);
+    assert(res11);
+    const auto n_vars3 = s3.snapshot().size();
+    bool res12 = s3.new_gt({{z3, 1}, {y3, 1}}, 2);
+    assert(res12);
+    assert(s3.snapshot().size() == n_vars3);
+    const utils::var sum3 = n_vars3 - 1;
+    assert(s3.lb(sum3) == 1);
+    assert(s3.ub(sum3) == 2);
+    assert(s3.check());
+    assert(s3.val(x3) + s3.val(y3) >= 1);
+    assert(s3.val(x3) + s3.val(y3) <= 2);
+}
+
 void test_expression_bounds_and_match()
 {
     linspire::solver s;
@@ -292,6 +405,1590 @@ void test_add_constraint_inconsistency_detection()
     assert(s.ub(x) == 1);
 }
 
+void test_incremental_violation_tracking()
+{
+    linspire::solver s;
+    auto x = s.new_var();
+    auto y = s.new_var();
+
+    // x + y >= 4 (the slack variable is basic and becomes violated)
+    bool res0 = s.new_gt({{x, 1}, {y, 1}}, 4);
+    assert(res0);
+    assert(s.check());
+    assert(s.val(x) + s.val(y) >= 4);
+
+    // nothing changed, hence nothing to repair
+    assert(s.check());
+
+    linspire::constraint c0;
+    // x - y >= 2
+    bool res1 = s.new_gt({{x, 1}, {y, -1}}, 2, false, c0);
+    assert(res1);
+    // x <= 5
+    bool res2 = s.new_lt({{x, 1}}, 5);
+    assert(res2);
+    assert(s.check());
+    assert(s.val(x) + s.val(y) >= 4);
+    assert(s.val(x) - s.val(y) >= 2);
+    assert(s.val(x) <= 5);
+
+    // y >= 4 makes the constraints inconsistent
+    linspire::constraint c1;
+    bool res3 = s.new_gt({{y, 1}}, 4, false, c1);
+    assert(!res3 || !s.check());
+
+    // retracting the constraint on `x - y` restores the consistency
+    s.retract(c0);
+    assert(s.check());
+    assert(s.val(x) + s.val(y) >= 4);
+    assert(s.val(x) <= 5);
+    assert(s.val(y) >= 4);
+}
+
+void test_implied_bounds_cache_invalidation()
+{
+    linspire::solver s;
+    auto x = s.new_var();
+    auto y = s.new_var();
+    auto sum = s.new_var(utils::lin{{x, 1}, {y, 1}});
+    assert(s.lb(sum) == utils::rational::negative_infinite);
+
+    linspire::constraint c0;
+    bool res0 = s.new_gt({{x, 1}}, 1, false, c0);
+    assert(res0);
+    bool res1 = s.new_gt({{y, 1}}, 2);
+    assert(res1);
+    assert(s.lb(sum) == 3); // the cached bounds are refreshed after the bounds of `x` and `y` change..
+    assert(s.ub(sum) == utils::rational::positive_infinite);
+
+    s.retract(c0);
+    assert(s.lb(sum) == utils::rational::negative_infinite);
+    bool res3 = s.new_lt({{sum, 1}}, 2);
+    assert(res3);
+    assert(s.check());
+    assert(s.val(x) + s.val(y) <= 2);
+    assert(s.ub(sum) == 2);
+}
+
+void test_pivot_rules()
+{
+    for (const auto leaving : {linspire::leaving_rule::bland, linspire::leaving_rule::max_violation, linspire::leaving_rule::least_infeasibility})
+        for (const auto entering : {linspire::entering_rule::bland, linspire::entering_rule::min_occurrences, linspire::entering_rule::greatest_slack, linspire::entering_rule::steepest_edge})
+            for (const std::size_t threshold : {0, 100})
+            {
+                linspire::solver s;
+                s.set_pivot_rule({leaving, entering, threshold});
+                assert(s.get_pivot_rule().leaving == leaving);
+                auto x = s.new_var();
+                auto y = s.new_var();
+                auto z = s.new_var();
+
+                // x + y + z >= 6, x - y >= 1, y - z >= 1, x <= 4, z >= 0
+                bool res0 = s.new_gt({{x, 1}, {y, 1}, {z, 1}}, 6);
+                assert(res0);
+                bool res1 = s.new_gt({{x, 1}, {y, -1}}, 1);
+                assert(res1);
+                bool res2 = s.new_gt({{y, 1}, {z, -1}}, 1);
+                assert(res2);
+                bool res3 = s.new_lt({{x, 1}}, 4);
+                assert(res3);
+                bool res4 = s.new_gt({{z, 1}}, 0);
+                assert(res4);
+                assert(s.check());
+                assert(s.val(x) + s.val(y) + s.val(z) >= 6);
+                assert(s.val(x) - s.val(y) >= 1);
+                assert(s.val(y) - s.val(z) >= 1);
+                assert(s.val(x) <= 4);
+                assert(s.val(z) >= 0);
+
+                // 2x + y <= 7 makes the constraints inconsistent
+                bool res5 = s.new_lt({{x, 2}, {y, 1}}, 7);
+                assert(!res5 || !s.check());
+            }
+}
+
+void test_flat_tableau_pivot()
+{
+    linspire::flat_tableau t;
+    for (int i = 0; i < 4; ++i)
+        t.add_var();
+    // x2 = x0 + x1, x3 = x0 - x1
+    t.add_row(2, utils::lin{{0, 1}, {1, 1}});
+    t.add_row(3, utils::lin{{0, 1}, {1, -1}});
+    assert(t.is_basic(2) && t.is_basic(3));
+    assert(t.column(0).size() == 2);
+
+    // x0 = x2 - x1, x3 = x2 - 2 x1
+    auto touched = t.pivot(2, 0);
+    assert(touched.size() == 1);
+    assert(t.is_basic(0) && !t.is_basic(2));
+    assert(t.column(0).empty());
+    assert(*t.coeff(0, 2) == 1 && *t.coeff(0, 1) == -1);
+    assert(*t.coeff(3, 2) == 1 && *t.coeff(3, 1) == -2);
+    assert(t.column(1).size() == 2 && t.column(2).size() == 2);
+    for (const auto v : {1, 2})
+        for (const auto &o : t.column(v))
+            assert(t.rows()[o.row].terms[o.pos].v == static_cast<utils::var>(v));
+
+    // x1 = 1/2 x2 - 1/2 x3, x0 = 1/2 x2 + 1/2 x3 (x2 cancels out in the first row)
+    t.pivot(3, 1);
+    assert(*t.coeff(1, 2) == utils::rational(1, 2) && *t.coeff(1, 3) == utils::rational(-1, 2));
+    assert(*t.coeff(0, 2) == utils::rational(1, 2) && *t.coeff(0, 3) == utils::rational(1, 2));
+    assert(t.column(1).empty());
+    assert(t.column(3).size() == 2);
+}
+
+void test_arith_fast_path()
+{
+    const utils::rational half(1, 2);
+    const utils::rational two(2), three(3);
+    assert(linspire::mul(three, utils::rational(4)) == 12);
+    assert(linspire::mul(half, utils::rational(4)) == 2);
+    assert(linspire::add_mul(utils::rational::one, three, utils::rational(-2)) == -5);
+    assert(linspire::add_mul(half, half, three) == 2);
+    assert(linspire::div(three, utils::rational(-1)) == -3);
+    assert(linspire::div(half, two) == utils::rational(1, 4));
+
+    utils::inf_rational acc(two, utils::rational::one);
+    linspire::add_mul(acc, three, utils::inf_rational(utils::rational::one, utils::rational(-1)));
+    assert(acc == utils::inf_rational(utils::rational(5), utils::rational(-2)));
+    linspire::add_mul(acc, half, utils::inf_rational(two));
+    assert(acc == utils::inf_rational(utils::rational(6), utils::rational(-2)));
+    assert(linspire::div(acc, utils::rational(-1)) == utils::inf_rational(utils::rational(-6), two));
+    assert(linspire::mul(two, utils::inf_rational(half, utils::rational::one)) == utils::inf_rational(utils::rational::one, two));
+
+    // infinite values fall back to the general arithmetic..
+    utils::inf_rational inf(utils::rational::positive_infinite);
+    linspire::add_mul(inf, two, utils::inf_rational(utils::rational::one));
+    assert(inf == utils::rational::positive_infinite);
+
+    // results which do not fit in machine integers are detected, new ones being fine..
+    assert(!linspire::arith_overflow);
+    const utils::rational big(std::int64_t(1) << 40), small(1, std::int64_t(1) << 40);
+    assert(linspire::mul(big, small) == 1);
+    assert(linspire::add_mul(half, small, utils::rational(1, 3)) == utils::rational(3 * (std::int64_t(1) << 39) + 1, 3 * (std::int64_t(1) << 40)));
+    assert(!linspire::arith_overflow);
+    [[maybe_unused]] const auto r0 = linspire::mul(big, big);
+    assert(linspire::arith_overflow);
+    linspire::arith_overflow = false;
+    [[maybe_unused]] const auto r1 = linspire::mul(small, small);
+    assert(linspire::arith_overflow);
+    linspire::arith_overflow = false;
+    [[maybe_unused]] const auto r2 = linspire::div(big, small);
+    assert(linspire::arith_overflow);
+
+    // the overflows of the thread do not leak into the solvers, which report their own ones to their next check alone..
+    linspire::solver s0;
+    auto x0 = s0.new_var(utils::inf_rational(utils::rational::zero));
+    bool res0 = s0.new_gt({{x0, 1}}, 1);
+    assert(res0);
+    assert(s0.check(linspire::check_budget()) == linspire::check_result::sat);
+    assert(linspire::arith_overflow); // the overflow of the thread is left to its owner..
+    linspire::arith_overflow = false;
+
+    // x / 2^40 + y >= 2^40, with x >= 0 and 0 <= y <= 1, makes `x` grow beyond 2^79..
+    linspire::solver s1;
+    auto x1 = s1.new_var(utils::inf_rational(utils::rational::zero));
+    auto y1 = s1.new_var(utils::inf_rational(utils::rational::zero), utils::inf_rational(utils::rational::one));
+    bool res1 = s1.new_gt({{x1, small}, {y1, 1}}, utils::lin(big));
+    assert(res1);
+    assert(s1.check(linspire::check_budget()) == linspire::check_result::unknown);
+    assert(!linspire::arith_overflow);
+    assert(s0.check(linspire::check_budget()) == linspire::check_result::sat);
+
+    // the pivots stop at the first overflow, rather than going on with meaningless values, possibly forever..
+    linspire::solver s3;
+    std::vector<utils::var> xs;
+    for (int i = 0; i < 4; ++i)
+        xs.push_back(s3.new_var());
+    const std::int64_t p27 = std::int64_t(1) << 27, p36 = std::int64_t(1) << 36, p38 = std::int64_t(1) << 38, p52 = std::int64_t(1) << 52;
+    bool res3 = s3.new_gt(utils::lin{{xs[0], -p27}, {xs[1], -p38}, {xs[3], 2}}, 5) &&
+                s3.new_lt(utils::lin{{xs[0], -5}, {xs[2], 5}}, utils::lin(utils::rational(p36))) &&
+                s3.new_gt(utils::lin{{xs[1], 3}, {xs[2], p38}, {xs[3], -2}}, -5) &&
+                s3.new_gt(utils::lin{{xs[0], 2}}, 3) &&
+                s3.new_gt(utils::lin{{xs[0], -2}, {xs[1], -p27}}, utils::lin(utils::rational(p52))) &&
+                s3.new_gt(utils::lin{{xs[2], 2}}, utils::lin(utils::rational(p36)));
+    assert(res3);
+    assert(s3.check(linspire::check_budget()) == linspire::check_result::unknown);
+
+    // without a budget, the overflow is told apart from an inconsistency by `overflowed()`..
+    linspire::solver s2;
+    auto x2 = s2.new_var(utils::inf_rational(utils::rational::zero));
+    auto y2 = s2.new_var(utils::inf_rational(utils::rational::zero), utils::inf_rational(utils::rational::one));
+    bool res2 = s2.new_gt({{x2, small}, {y2, 1}}, utils::lin(big));
+    assert(res2);
+    assert(!s2.check());
+    assert(s2.overflowed());
+    assert(s2.get_conflict().empty());
+    assert(!linspire::arith_overflow);
+
+    // 3y < -2^45, 3x - 3y < 0 and -2x + 2^36 y = 2^57 are satisfiable, though only by values beyond 2^64..
+    linspire::solver s4;
+    auto x4 = s4.new_var();
+    auto y4 = s4.new_var();
+    const std::int64_t p45 = std::int64_t(1) << 45, p57 = std::int64_t(1) << 57;
+    bool res4 = s4.new_lt(utils::lin{{y4, 3}}, utils::lin(utils::rational(-p45)), true) &&
+                s4.new_lt(utils::lin{{x4, 3}, {y4, -3}}, 0, true) &&
+                s4.new_eq(utils::lin{{x4, -2}, {y4, p36}}, utils::lin(utils::rational(p57)));
+    assert(res4);
+    if (s4.check())
+    { // the model, if any, is exact, as checked without overflows..
+        assert(!s4.overflowed());
+        assert(linspire::mul(utils::rational(3), s4.val(y4)) < utils::rational(-p45));
+        assert(s4.val(x4) < s4.val(y4));
+        auto v4 = linspire::mul(utils::rational(-2), s4.val(x4));
+        linspire::add_mul(v4, utils::rational(p36), s4.val(y4));
+        assert(!linspire::arith_overflow);
+        assert(v4 == utils::inf_rational(utils::rational(p57)));
+    }
+    else // the overflow prevents any answer, rather than giving a wrong one..
+        assert(s4.overflowed());
+
+    // 3x > -2^42 and -2^40 y < 5 make the implied lower bound of x + y overflow, which proves nothing against x + y < -7..
+    linspire::solver s5;
+    auto x5 = s5.new_var();
+    auto y5 = s5.new_var();
+    const std::int64_t p40 = std::int64_t(1) << 40, p42 = std::int64_t(1) << 42;
+    bool res5 = s5.new_gt(utils::lin{{x5, 3}}, utils::lin(utils::rational(-p42)), true) &&
+                s5.new_lt(utils::lin{{y5, -p40}}, 5, true) &&
+                s5.new_lt(utils::lin{{x5, 1}, {y5, 1}}, -7, true);
+    assert(res5);
+    assert(s5.check() || s5.overflowed());
+}
+
+void test_float_presolve()
+{
+    linspire::solver s;
+    s.set_float_presolve(true);
+    assert(s.get_float_presolve());
+    auto x = s.new_var();
+    auto y = s.new_var();
+    auto z = s.new_var();
+
+    // x + y + z >= 6, x - y > 1/3, y - z >= 1, x <= 4, z >= 0
+    bool res0 = s.new_gt({{x, 1}, {y, 1}, {z, 1}}, 6);
+    assert(res0);
+    bool res1 = s.new_gt({{x, 1}, {y, -1}}, utils::rational(1, 3), true);
+    assert(res1);
+    bool res2 = s.new_gt({{y, 1}, {z, -1}}, 1);
+    assert(res2);
+    bool res3 = s.new_lt({{x, 1}}, 4);
+    assert(res3);
+    bool res4 = s.new_gt({{z, 1}}, 0);
+    assert(res4);
+    assert(s.check());
+    // the solution is exact, strict bounds included..
+    assert(s.val(x) + s.val(y) + s.val(z) >= 6);
+    assert(s.val(x) - s.val(y) > utils::rational(1, 3));
+    assert(s.val(y) - s.val(z) >= 1);
+    assert(s.val(x) <= 4);
+    assert(s.val(z) >= 0);
+
+    // 2x + y <= 7 makes the constraints inconsistent, and the conflict is explained exactly
+    linspire::constraint c;
+    bool res5 = s.new_lt({{x, 2}, {y, 1}}, 7, false, c);
+    assert(!res5 || !s.check());
+    assert(!s.get_conflict().empty());
+}
+
+void test_fixed_elimination()
+{
+    linspire::solver s;
+    s.set_fixed_elimination(true);
+    assert(s.get_fixed_elimination());
+    auto x = s.new_var();
+    auto y = s.new_var();
+    auto z = s.new_var();
+
+    // x + y + z == 6, x - y == 1, y + z >= 3, z <= 1
+    linspire::constraint c0, c1, c2, c3;
+    bool res0 = s.new_eq({{x, 1}, {y, 1}, {z, 1}}, 6, c0);
+    assert(res0);
+    bool res1 = s.new_eq({{x, 1}, {y, -1}}, 1, c1);
+    assert(res1);
+    bool res2 = s.new_gt({{y, 1}, {z, 1}}, 3, false, c2);
+    assert(res2);
+    bool res3 = s.new_lt({{z, 1}}, 1, false, c3);
+    assert(res3);
+    assert(s.check());
+    assert(s.val(x) + s.val(y) + s.val(z) == 6);
+    assert(s.val(x) - s.val(y) == 1);
+    assert(s.val(y) + s.val(z) >= 3);
+    assert(s.val(z) <= 1);
+
+    // the eliminated equalities still take part in the conflict explanations: x + y >= 6 forces y >= 5/2 and y <= 2..
+    linspire::constraint c4;
+    bool res4 = s.new_gt({{x, 1}, {y, 1}}, 6, false, c4);
+    assert(!res4 || !s.check()); // the bounds implied by the new row might already be inconsistent..
+    const auto &cnfl = s.get_conflict();
+    assert(std::find_if(cnfl.cbegin(), cnfl.cend(), [&c0](const auto &c)
+                        { return &c.get() == &c0; }) != cnfl.cend());
+
+    // retracting a bound of an eliminated equality releases the eliminated variable..
+    s.retract(c4);
+    assert(s.check());
+    s.retract(c1);
+    linspire::constraint c5;
+    bool res5 = s.new_eq({{x, 1}, {y, -1}}, 0, c5);
+    assert(res5);
+    assert(s.check());
+    assert(s.val(x) == s.val(y));
+    assert(s.val(x) + s.val(y) + s.val(z) == 6);
+}
+
+void test_expr_table()
+{
+    linspire::expr_table t;
+    // the table grows while keeping all the expressions..
+    for (utils::var i = 0; i < 100; ++i)
+        t.insert(utils::lin{{i, 1}, {i + 1, utils::rational(-1, 2)}}, i);
+    assert(t.size() == 100);
+    for (utils::var i = 0; i < 100; ++i)
+        assert(t.find(utils::lin{{i, 1}, {i + 1, utils::rational(-1, 2)}}) == i);
+    // expressions are compared structurally..
+    assert(!t.find(utils::lin{{0, 1}, {1, utils::rational(1, 2)}}));
+    assert(!t.find(utils::lin{{0, 1}, {2, utils::rational(-1, 2)}}));
+    assert(!t.find(utils::lin{{0, 1}}));
+
+    // removed expressions do not break the probe sequences of the others..
+    for (utils::var i = 0; i < 100; i += 2)
+        assert(t.erase(utils::lin{{i, 1}, {i + 1, utils::rational(-1, 2)}}));
+    assert(!t.erase(utils::lin{{0, 1}, {1, utils::rational(-1, 2)}}));
+    assert(t.size() == 50);
+    for (utils::var i = 0; i < 100; ++i)
+        assert(t.find(utils::lin{{i, 1}, {i + 1, utils::rational(-1, 2)}}).has_value() == (i % 2 == 1));
+    t.insert(utils::lin{{0, 1}, {1, utils::rational(-1, 2)}}, 200);
+    assert(t.find(utils::lin{{0, 1}, {1, utils::rational(-1, 2)}}) == 200);
+}
+
+void test_push_pop()
+{
+    linspire::solver s;
+    auto x = s.new_var();
+    auto y = s.new_var();
+    linspire::constraint c0;
+    bool res0 = s.new_gt({{x, 1}}, 0, false, c0);
+    assert(res0);
+    assert(s.check());
+
+    s.push();
+    assert(s.get_level() == 1);
+    // x + y <= 4, x >= 3, y >= 2 is inconsistent
+    linspire::constraint c1, c2;
+    bool res1 = s.new_lt({{x, 1}, {y, 1}}, 4, false, c1);
+    assert(res1);
+    bool res2 = s.new_gt({{x, 1}}, 3, false, c2); // c2 also tightens the bound of x..
+    assert(res2);
+    assert(s.lb(x) == 3);
+    s.push();
+    bool res3 = s.new_gt({{y, 1}}, 2);
+    assert(!res3 || !s.check());
+    s.pop();
+    assert(s.check());
+    assert(s.lb(x) == 3);
+
+    s.pop();
+    assert(s.get_level() == 0);
+    // the bounds and the slack variable created after the first push are gone..
+    assert(s.lb(x) == 0);
+    assert(s.ub(x) == utils::rational::positive_infinite);
+    assert(s.check());
+    auto z = s.new_var();
+    assert(z == y + 1);
+    bool res4 = s.new_gt({{y, 1}}, 10);
+    assert(res4);
+    bool res5 = s.new_gt({{x, 1}}, 10);
+    assert(res5);
+    assert(s.check());
+
+    // a slack variable followed by other variables leaves its identifier to the next ones..
+    s.push();
+    bool res6 = s.new_lt({{x, 1}, {z, 1}}, 30);
+    assert(res6);
+    const utils::var sum = z + 1;
+    assert(s.snapshot().size() == sum + 1);
+    auto w = s.new_var();
+    s.pop();
+    assert(s.snapshot().size() == w + 1);
+    auto v = s.new_var();
+    assert(v == sum);
+    assert(s.lb(v) == utils::rational::negative_infinite && s.ub(v) == utils::rational::positive_infinite);
+    bool res7 = s.new_lt({{x, 1}, {z, 1}}, 30);
+    assert(res7);
+    assert(s.snapshot().size() == w + 2); // the expression gets a new slack variable..
+    assert(s.check());
+}
+
+void test_batch_ingestion()
+{
+    linspire::solver s;
+    std::vector<utils::var> xs;
+    for (int i = 0; i < 10; ++i)
+        xs.push_back(s.new_var());
+
+    s.begin_batch();
+    // x_i >= i, x_i + x_{i+1} <= 4 i + 10
+    for (int i = 0; i < 10; ++i)
+    {
+        bool res0 = s.new_gt({{xs[i], 1}}, i);
+        assert(res0);
+        if (i + 1 < 10)
+        {
+            bool res1 = s.new_lt({{xs[i], 1}, {xs[i + 1], 1}}, 4 * i + 10);
+            assert(res1);
+        }
+    }
+    // bounds are still checked during the batch..
+    bool res2 = s.new_lt({{xs[0], 1}}, -1);
+    assert(!res2);
+    s.commit();
+    for (int i = 0; i < 10; ++i)
+        assert(s.val(xs[i]) >= i);
+    assert(s.check());
+    for (int i = 0; i + 1 < 10; ++i)
+        assert(s.val(xs[i]) + s.val(xs[i + 1]) <= 4 * i + 10);
+
+    // the check procedure commits the batch implicitly..
+    s.begin_batch();
+    bool res3 = s.new_gt({{xs[0], 1}}, 5);
+    assert(res3);
+    assert(s.check());
+    assert(s.val(xs[0]) >= 5);
+}
+
+void test_bound_stack()
+{
+    linspire::solver s;
+    auto x = s.new_var();
+
+    // x >= 1 (without reason), x >= 3 (twice), x >= 2, x <= 10
+    bool res0 = s.new_gt({{x, 1}}, 1);
+    assert(res0);
+    linspire::constraint c0, c1, c2, c3;
+    bool res1 = s.new_gt({{x, 1}}, 3, false, c0);
+    assert(res1);
+    bool res2 = s.new_gt({{x, 1}}, 3, false, c1);
+    assert(res2);
+    bool res3 = s.new_gt({{x, 1}}, 2, false, c2);
+    assert(res3);
+    bool res4 = s.new_lt({{x, 1}}, 10, false, c3);
+    assert(res4);
+    assert(s.lb(x) == 3);
+    assert(s.ub(x) == 10);
+
+    // a single reason of the tightest lower bound is enough to explain the conflict..
+    bool res5 = s.new_lt({{x, 1}}, 0);
+    assert(!res5);
+    assert(s.get_conflict().size() == 1);
+    assert(&s.get_conflict()[0].get() == &c0);
+
+    s.retract(c0);
+    assert(s.lb(x) == 3);
+    s.retract(c1);
+    assert(s.lb(x) == 2);
+    s.retract(c2);
+    assert(s.lb(x) == 1); // bounds without reason are never retracted..
+    s.retract(c3);
+    assert(s.ub(x) == utils::rational::positive_infinite);
+    assert(s.check());
+}
+
+void test_farkas_conflict()
+{
+    linspire::solver s;
+    auto x = s.new_var();
+    auto y = s.new_var();
+
+    // x <= 2, y >= 2, x - y >= 1 (i.e., y - x <= -1)
+    linspire::constraint c0, c1, c2;
+    bool res0 = s.new_lt({{x, 1}}, 2, false, c0);
+    assert(res0);
+    bool res1 = s.new_gt({{y, 1}}, 2, false, c1);
+    assert(res1);
+    bool res2 = s.new_gt({{x, 1}, {y, -1}}, 1, false, c2);
+    assert(!res2);
+
+    // 1 * x - 1 * y + 1 * (y - x) = 0, while 1 * 2 - 1 * 2 + 1 * -1 = -1 < 0
+    const auto &cnfl = s.get_conflict();
+    const auto &coeffs = s.get_conflict_coefficients();
+    assert(cnfl.size() == 3);
+    assert(coeffs.size() == 3);
+    for (std::size_t i = 0; i < cnfl.size(); ++i)
+        if (&cnfl[i].get() == &c0)
+            assert(coeffs[i] == 1);
+        else if (&cnfl[i].get() == &c1)
+            assert(coeffs[i] == -1);
+        else
+        {
+            assert(&cnfl[i].get() == &c2);
+            assert(coeffs[i] == 1);
+        }
+
+    // x + 2 y <= 3, x - y <= 4 and x >= 4 (with the same reason), y >= 0 -> a conflict found by the check procedure..
+    linspire::solver s1;
+    s1.set_conflict_minimization(true);
+    x = s1.new_var();
+    y = s1.new_var();
+    linspire::constraint c3, c4, c5;
+    bool res3 = s1.new_lt({{x, 1}, {y, 2}}, 3, false, c3);
+    assert(res3);
+    bool res4 = s1.new_lt({{x, 1}, {y, -1}}, 4, false, c4);
+    assert(res4);
+    bool res5 = s1.new_gt({{y, 1}}, 0, false, c5);
+    assert(res5);
+    bool res6 = s1.new_gt({{x, 1}}, 4, false, c4);
+    assert(res6);
+    assert(!s1.check());
+
+    // the bounds of `c4` alone make `y >= 0` redundant..
+    const auto &cnfl1 = s1.get_conflict();
+    assert(cnfl1.size() == 2);
+    for (const auto &c : cnfl1)
+        assert(&c.get() == &c3 || &c.get() == &c4);
+
+    // 2x + 2y <= 4 and 3x - 3y <= 3 (with the same reason, scaled differently), x >= 2, y >= -10 -> a conflict whose multipliers are proportional to 1/2 + 1/3 and -2..
+    for (const bool minimize : {false, true})
+    {
+        linspire::solver s2;
+        s2.set_conflict_minimization(minimize);
+        x = s2.new_var();
+        y = s2.new_var();
+        linspire::constraint c6, c7, c8;
+        bool res7 = s2.new_lt({{x, 2}, {y, 2}}, 4, false, c6);
+        assert(res7);
+        bool res8 = s2.new_lt({{x, 3}, {y, -3}}, 3, false, c6);
+        assert(res8);
+        bool res9 = s2.new_gt({{y, 1}}, -10, false, c8);
+        assert(res9);
+        bool res10 = s2.new_gt({{x, 1}}, 2, false, c7);
+        assert(res10);
+        assert(!s2.check());
+
+        const auto &cnfl2 = s2.get_conflict();
+        const auto &coeffs2 = s2.get_conflict_coefficients();
+        assert(cnfl2.size() == 2);
+        utils::rational m6, m7;
+        for (std::size_t i = 0; i < cnfl2.size(); ++i)
+            if (&cnfl2[i].get() == &c6)
+                m6 = coeffs2[i];
+            else
+            {
+                assert(&cnfl2[i].get() == &c7);
+                m7 = coeffs2[i];
+            }
+        assert(is_negative(m7));
+        assert(m6 * utils::rational(-12) == m7 * utils::rational(5));
+    }
+
+    // x2 - x3 <= -2, -5 x1 - 2 x3 + x2 > -1 and x2 - x3 > 6, the last one bounding the slack of the first from below after a check..
+    linspire::solver s3;
+    std::vector<utils::var> xs;
+    for (int i = 0; i < 4; ++i)
+        xs.push_back(s3.new_var());
+    linspire::constraint c9, c10, c11;
+    bool res11 = s3.new_lt(utils::lin{{xs[2], 1}, {xs[3], -1}}, -2, false, c9);
+    assert(res11);
+    bool res12 = s3.new_gt(utils::lin{{xs[1], -5}, {xs[3], -2}, {xs[2], 1}}, -1, true, c10);
+    assert(res12);
+    assert(s3.check());
+    bool res13 = s3.new_gt(utils::lin{{xs[2], 1}, {xs[3], -1}}, 6, true, c11);
+    assert(!res13);
+    // 1 * (x2 - x3) + 1 * (x3 - x2) = 0, while 1 * -2 + 1 * -6 = -8 < 0
+    assert(s3.get_conflict().size() == 2);
+    for (std::size_t i = 0; i < s3.get_conflict().size(); ++i)
+    {
+        assert(&s3.get_conflict()[i].get() == &c9 || &s3.get_conflict()[i].get() == &c11);
+        assert(s3.get_conflict_coefficients()[i] == 1);
+    }
+
+    // the multipliers of random conflicts follow the documented convention..
+    struct written
+    {
+        utils::lin e;     // `lhs - rhs`, or `rhs - lhs` for `new_gt`, which is non-positive..
+        bool eq, strict;
+    };
+    std::mt19937 gen(42);
+    for (int it = 0; it < 500; ++it)
+    {
+        linspire::solver s4;
+        s4.set_conflict_minimization(it % 2);
+        std::vector<utils::var> ys;
+        for (int i = 0; i < 3; ++i)
+            ys.push_back(s4.new_var());
+        std::deque<linspire::constraint> cs;
+        std::vector<written> ws;
+        bool cons = true;
+        for (int k = 0; k < 8 && cons; ++k)
+        {
+            utils::lin l;
+            if (gen() % 2) // a single variable, or a difference..
+            {
+                const auto a = static_cast<std::int64_t>(gen() % 3) + 1;
+                const auto i = gen() % 3, j = gen() % 3;
+                l.vars.emplace(ys[i], gen() % 2 ? a : -a);
+                if (i != j && gen() % 2)
+                    l.vars.emplace(ys[j], l.vars.at(ys[i]) * -1);
+            }
+            else
+                for (const auto &y : ys)
+                    if (const auto c = static_cast<std::int64_t>(gen() % 7) - 3; c)
+                        l.vars.emplace(y, c);
+            if (l.vars.empty())
+                continue;
+            const utils::lin k0(utils::rational(static_cast<std::int64_t>(gen() % 13) - 6));
+            const auto op = gen() % 5;
+            const bool strict = op < 4 && gen() % 2;
+            auto &c = cs.emplace_back();
+            if (op == 4)
+            {
+                ws.push_back({linspire::sub(l, k0), true, false});
+                cons = s4.new_eq(l, k0, c);
+            }
+            else if (op < 2)
+            {
+                ws.push_back({linspire::sub(l, k0), false, strict});
+                cons = s4.new_lt(l, k0, strict, c);
+            }
+            else
+            {
+                ws.push_back({linspire::sub(k0, l), false, strict});
+                cons = s4.new_gt(l, k0, strict, c);
+            }
+            if (cons && gen() % 3 == 0)
+                cons = s4.check();
+        }
+        if (cons)
+            continue;
+        // each multiplier refers to its expression, divided by the coefficient when a single variable is left..
+        const auto &cnfl = s4.get_conflict();
+        const auto &coeffs = s4.get_conflict_coefficients();
+        assert(!cnfl.empty());
+        std::map<utils::var, utils::rational> sum;
+        utils::rational k_sum;
+        bool strict = false;
+        for (std::size_t i = 0; i < cnfl.size(); ++i)
+        {
+            const auto j = static_cast<std::size_t>(std::find_if(cs.begin(), cs.end(), [&](const linspire::constraint &c)
+                                                                 { return &c == &cnfl[i].get(); }) -
+                                                    cs.begin());
+            assert(j < ws.size());
+            const auto &w = ws[j];
+            const auto lambda = w.e.vars.size() == 1 ? coeffs[i] / w.e.vars.cbegin()->second : coeffs[i]; // the multiplier of `w.e <= 0`..
+            assert(w.eq || !is_negative(lambda));
+            for (const auto &[v, c] : w.e.vars)
+                sum[v] += lambda * c;
+            k_sum += lambda * w.e.known_term;
+            strict = strict || (w.strict && is_positive(lambda));
+        }
+        for (const auto &[v, c] : sum)
+            assert(is_zero(c));
+        assert(is_positive(k_sum) || (is_zero(k_sum) && strict));
+    }
+}
+
+void test_propagate()
+{
+    linspire::solver s;
+    auto x = s.new_var();
+    auto y = s.new_var();
+
+    // x + y <= 4, x >= 1, y >= 2
+    linspire::constraint c0, c1, c2;
+    bool res0 = s.new_lt({{x, 1}, {y, 1}}, 4, false, c0);
+    assert(res0);
+    bool res1 = s.new_gt({{x, 1}}, 1, false, c1);
+    assert(res1);
+    bool res2 = s.new_gt({{y, 1}}, 2, false, c2);
+    assert(res2);
+
+    // x <= 2 and y <= 3 are implied by the row of `x + y`, without any pivoting..
+    assert(s.propagate(10));
+    bool x_ub = false, y_ub = false;
+    for (const auto &ib : s.get_implied_bounds())
+        if (ib.x == x && ib.upper)
+        {
+            x_ub = true;
+            assert(ib.value == 2);
+            assert(ib.reasons.size() == 2);
+            for (const auto &r : ib.reasons)
+                assert(&r.get() == &c0 || &r.get() == &c2);
+        }
+        else if (ib.x == y && ib.upper)
+        {
+            y_ub = true;
+            assert(ib.value == 3);
+        }
+    assert(x_ub && y_ub);
+
+    // x >= 3 is inconsistent with the implied upper bound of `x`..
+    linspire::constraint c3;
+    bool res3 = s.new_gt({{x, 1}}, 3, false, c3);
+    assert(res3);
+    assert(!s.propagate(10));
+    assert(s.get_conflict().size() == 3);
+    for (const auto &c : s.get_conflict())
+        assert(&c.get() == &c0 || &c.get() == &c2 || &c.get() == &c3);
+    assert(!s.check());
+
+    // the implied bounds do not survive the retraction of their reasons..
+    s.retract(c2);
+    assert(s.propagate(10));
+    for (const auto &ib : s.get_implied_bounds())
+    {
+        assert(ib.x != x || !ib.upper);
+        for (const auto &r : ib.reasons)
+            assert(&r.get() != &c2);
+    }
+    assert(s.check());
+}
+
+#ifdef LINSPIRE_ENABLE_LISTENERS
+class counting_listener : public linspire::listener
+{
+public:
+    counting_listener(linspire::solver &slv, const std::vector<utils::var> &vs) noexcept : listener(slv)
+    {
+        for (const auto &v : vs)
+            listen(v);
+    }
+
+    void on_value_changed(const utils::var) noexcept override { ++n_changes; }
+    void on_values_changed(const std::vector<utils::var> &vs) noexcept override
+    {
+        ++n_batches;
+        n_changes += vs.size();
+        for (const auto &v : vs)
+            changed.push_back(v);
+    }
+
+    std::size_t n_changes = 0, n_batches = 0;
+    std::vector<utils::var> changed;
+};
+
+void test_deferred_notifications()
+{
+    linspire::solver s;
+    std::vector<utils::var> xs;
+    for (int i = 0; i < 5; ++i)
+        xs.push_back(s.new_var());
+    counting_listener l(s, xs);
+
+    s.set_deferred_notifications(true);
+    // x_i + x_{i+1} >= 2 i + 1
+    for (int i = 0; i + 1 < 5; ++i)
+    {
+        bool res = s.new_gt({{xs[i], 1}, {xs[i + 1], 1}}, 2 * i + 1);
+        assert(res);
+    }
+    assert(l.n_changes == 0);
+    assert(s.check());
+
+    // a single call, with each changed variable listed once..
+    assert(l.n_batches == 1);
+    std::sort(l.changed.begin(), l.changed.end());
+    assert(std::adjacent_find(l.changed.begin(), l.changed.end()) == l.changed.end());
+    for (const auto &v : l.changed)
+        assert(std::find(xs.begin(), xs.end(), v) != xs.end());
+
+    // the values are notified immediately once the deferral is disabled..
+    s.set_deferred_notifications(false);
+    const auto n_changes = l.n_changes;
+    bool res = s.new_gt({{xs[0], 1}}, 10);
+    assert(res);
+    assert(s.check());
+    assert(l.n_changes > n_changes);
+    assert(l.n_batches == 1);
+}
+#endif
+
+void test_difference_logic()
+{
+    linspire::solver s;
+    auto x0 = s.new_var();
+    auto x1 = s.new_var();
+    auto x2 = s.new_var();
+
+    // x1 - x0 >= 1, x2 - x1 >= 1, x0 >= 0, x2 <= 5: just differences and bounds, hence solved by the difference graph..
+    linspire::constraint c0, c1, c2, c3;
+    bool res0 = s.new_gt({{x1, 1}, {x0, -1}}, 1, false, c0);
+    assert(res0);
+    bool res1 = s.new_gt({{x2, 1}, {x1, -1}}, 1, false, c1);
+    assert(res1);
+    bool res2 = s.new_gt({{x0, 1}}, 0, false, c2);
+    assert(res2);
+    bool res3 = s.new_lt({{x2, 1}}, 5, false, c3);
+    assert(res3);
+    assert(s.check());
+    assert(s.val(x1) - s.val(x0) >= 1);
+    assert(s.val(x2) - s.val(x1) >= 1);
+    assert(s.val(x0) >= 0);
+    assert(s.val(x2) <= 5);
+    const auto n_rows = [&s]
+    {
+        std::size_t n = 0;
+        for (const auto k : s.memory_usage().row_density)
+            n += k;
+        return n;
+    };
+    assert(n_rows() == 0); // the graph enforces the differences, with no tableau rows..
+
+    // x2 - x0 <= 1 closes a negative cycle with the first two constraints..
+    linspire::constraint c4;
+    if (s.new_lt({{x2, 1}, {x0, -1}}, 1, false, c4))
+        assert(!s.check());
+    // (x0 - x1) + (x1 - x2) + (x2 - x0) = 0, while -1 - 1 + 1 = -1 < 0
+    const auto &cnfl = s.get_conflict();
+    const auto &coeffs = s.get_conflict_coefficients();
+    assert(cnfl.size() == 3);
+    for (std::size_t i = 0; i < cnfl.size(); ++i)
+    {
+        assert(&cnfl[i].get() == &c0 || &cnfl[i].get() == &c1 || &cnfl[i].get() == &c4);
+        assert(coeffs[i] == 1);
+    }
+#ifdef LINSPIRE_ENABLE_STATISTICS
+    assert(s.stats().n_pivots == 0);
+#endif
+
+    s.retract(c4);
+    assert(s.check());
+    assert(s.val(x2) - s.val(x0) >= 2);
+
+    // x0 + x2 >= 7 is not a difference, hence the simplex takes over, with a row for each constraint..
+    linspire::constraint c5;
+    bool res5 = s.new_gt({{x0, 1}, {x2, 1}}, 7, false, c5);
+    assert(res5);
+    assert(n_rows() == 3);
+    assert(s.check());
+    assert(s.val(x1) - s.val(x0) >= 1);
+    assert(s.val(x2) - s.val(x1) >= 1);
+    assert(s.val(x0) + s.val(x2) >= 7);
+    assert(s.val(x0) >= 0);
+    assert(s.val(x2) <= 5);
+
+    // the slack variables of the differences undone by `pop` leave the graph along with their identifiers..
+    linspire::solver s2;
+    std::vector<utils::var> ys;
+    for (int i = 0; i < 4; ++i)
+        ys.push_back(s2.new_var());
+    s2.push();
+    bool res6 = s2.new_gt(utils::lin{{ys[3], 3}, {ys[2], -1}}, -3, true);
+    bool res7 = s2.new_lt(utils::lin{{ys[2], 1}, {ys[3], -1}}, -6, true);
+    assert(res6 && res7);
+    s2.pop();
+    bool res8 = s2.new_gt(utils::lin{{ys[2], 1}, {ys[1], -1}}, -6);
+    assert(res8);
+    s2.compact();
+    assert(s2.check());
+    assert(s2.val(ys[2]) - s2.val(ys[1]) >= -6);
+
+    // y - x >= -2/3, y <= 1, x > 2 and x - y > 0: the bound on the slack variable of `x - y` is looser than the one implied by its difference..
+    linspire::solver s3;
+    auto x3 = s3.new_var();
+    auto y3 = s3.new_var();
+    bool res9 = s3.new_gt(utils::lin{{x3, -3}, {y3, 3}}, -2);
+    assert(res9);
+    bool res10 = s3.new_lt(utils::lin{{y3, 1}}, 1);
+    assert(res10);
+    bool res11 = s3.new_lt(utils::lin{{x3, -2}}, -4, true);
+    assert(res11);
+    bool res12 = s3.new_gt(utils::lin{{x3, 1}, {y3, -1}}, 0, true);
+    assert(!res12 || !s3.check());
+}
+
+void test_snapshot()
+{
+    linspire::solver s;
+    std::vector<utils::var> xs;
+    for (std::size_t i = 0; i < 2 * linspire::solver_snapshot::chunk_size; ++i)
+        xs.push_back(s.new_var());
+
+    // x0 + x1 >= 2, x0 <= 1
+    bool res0 = s.new_gt({{xs[0], 1}, {xs[1], 1}}, 2);
+    assert(res0);
+    bool res1 = s.new_lt({{xs[0], 1}}, 1);
+    assert(res1);
+    assert(s.check());
+
+    const auto s0 = s.snapshot();
+    assert(s0.size() == xs.size() + 1); // the slack variable of `x0 + x1`..
+    for (utils::var x = 0; x < s0.size(); ++x)
+    {
+        assert(s0.val(x) == s.val(x));
+        assert(s0.lb(x) == s.lb(x));
+        assert(s0.ub(x) == s.ub(x));
+    }
+    const auto x0_ub = s0.ub(xs[0]);
+    const auto last_val = s0.val(xs.back());
+
+    // the changes of the solver do not affect the previous snapshots..
+    bool res2 = s.new_lt({{xs[0], 1}}, 0);
+    assert(res2);
+    bool res3 = s.new_gt({{xs.back(), 1}}, 5);
+    assert(res3);
+    assert(s.check());
+    assert(s0.ub(xs[0]) == x0_ub);
+    assert(s0.val(xs.back()) == last_val);
+
+    const auto s1 = s.snapshot();
+    assert(s1.ub(xs[0]) == utils::inf_rational(utils::rational::zero));
+    assert(s1.lb(xs.back()) == utils::inf_rational(utils::rational(5)));
+    assert(s1.val({{xs[0], 1}, {xs[1], 1}}) >= 2);
+    assert(s1.match({{xs[0], 1}}, utils::lin(utils::rational(-1))));
+    assert(!s1.match({{xs[0], 1}}, utils::lin(utils::rational(1))));
+}
+
+#ifdef LINSPIRE_ENABLE_TRACE
+void test_trace()
+{
+    linspire::solver s;
+    auto x = s.new_var();
+    auto y = s.new_var();
+
+    // x + y >= 2, x - 2 y >= 1, x <= 1: the check procedure pivots before finding the conflict..
+    bool res0 = s.new_gt({{x, 1}, {y, 1}}, 2);
+    assert(res0);
+    bool res1 = s.new_gt({{x, 1}, {y, -2}}, 1);
+    assert(res1);
+    assert(s.check());
+    bool res2 = s.new_lt({{x, 1}, {y, 3}}, -1);
+    assert(res2);
+    bool res3 = s.new_lt({{x, 1}}, 1);
+    if (res3)
+        assert(!s.check());
+
+    const auto events = s.get_trace().get_events();
+    assert(events.size() == s.get_trace().size());
+    assert(std::any_of(events.cbegin(), events.cend(), [](const linspire::trace_event &e)
+                       { return e.k == linspire::trace_event::kind::pivot; }));
+    assert(std::any_of(events.cbegin(), events.cend(), [](const linspire::trace_event &e)
+                       { return e.k == linspire::trace_event::kind::upper_bound; }));
+    assert(events.back().k == linspire::trace_event::kind::conflict);
+    for (std::size_t i = 1; i < events.size(); ++i)
+        assert(events[i - 1].time <= events[i].time);
+
+    std::ostringstream os;
+    s.get_trace().dump(os);
+    assert(os.str().size() == 16 + events.size() * 25);
+    assert(os.str().compare(0, 8, "LSTRACE1") == 0);
+
+    // once full, the buffer keeps the most recent events..
+    linspire::trace_buffer b(3);
+    assert(b.capacity() == 4);
+    for (std::uint64_t i = 0; i < 10; ++i)
+        b.record(linspire::trace_event::kind::update, i);
+    assert(b.size() == 4);
+    assert(b.recorded() == 10);
+    const auto b_events = b.get_events();
+    for (std::size_t i = 0; i < b_events.size(); ++i)
+        assert(b_events[i].x == 6 + i);
+    b.clear();
+    assert(b.size() == 0);
+}
+#endif
+
+void test_save_load()
+{
+    linspire::solver s;
+    auto x = s.new_var();
+    auto y = s.new_var();
+    auto z = s.new_var();
+
+    // x + y >= 2, x - y <= 1, y + z <= 4, z >= 1
+    linspire::constraint c0, c1, c2;
+    bool res0 = s.new_gt({{x, 1}, {y, 1}}, 2, false, c0);
+    assert(res0);
+    bool res1 = s.new_lt({{x, 1}, {y, -1}}, 1, false, c1);
+    assert(res1);
+    bool res2 = s.new_lt({{y, 1}, {z, 1}}, 4, false, c2);
+    assert(res2);
+    bool res3 = s.new_gt({{z, 1}}, 1);
+    assert(res3);
+    assert(s.check());
+
+    std::stringstream ss;
+    assert(!s.save(ss, {c0, c1})); // the reason `c2` is missing..
+    ss.str("");
+    assert(s.save(ss, {c0, c1, c2}));
+    const auto state = ss.str();
+
+    linspire::solver r;
+    linspire::constraint r0, r1, r2;
+    std::stringstream truncated(state.substr(0, state.size() / 2));
+    assert(!r.load(truncated, {r0, r1, r2}));
+    std::stringstream in(state);
+    assert(!r.load(in, {r0, r1})); // the number of constraints does not match..
+    in.clear();
+    in.seekg(0);
+    assert(r.load(in, {r0, r1, r2}));
+    for (utils::var v = 0; v <= z + 3; ++v)
+    {
+        assert(r.val(v) == s.val(v));
+        assert(r.lb(v) == s.lb(v));
+        assert(r.ub(v) == s.ub(v));
+    }
+#ifdef LINSPIRE_ENABLE_STATISTICS
+    assert(r.check());
+    assert(r.stats().n_pivots == 0); // the basis is restored as well..
+#endif
+
+    // the slack variables are restored as well, hence they are reused as in the saved solver..
+    bool res6 = s.new_gt({{x, 1}, {y, 1}}, 0);
+    assert(res6);
+    bool res7 = r.new_gt({{x, 1}, {y, 1}}, 0);
+    assert(res7);
+    assert(r.snapshot().size() == s.snapshot().size());
+
+    // the restored solver keeps working, with the restored constraints..
+    bool res4 = r.new_gt({{x, 1}}, 5);
+    assert(res4);
+    assert(!r.check());
+    r.retract(r1);
+    assert(r.check());
+    assert(r.val(x) >= 5);
+    assert(r.val(y) + r.val(z) <= 4);
+    bool res5 = r.add_constraint(r1);
+    assert(!res5 || !r.check());
+
+    // x + y >= 2, x - y <= 1, y + z <= 4, whose row is kept aside once retracted, while the check makes its variables basic..
+    linspire::solver s1;
+    x = s1.new_var();
+    y = s1.new_var();
+    z = s1.new_var();
+    linspire::constraint c3, c4, c5;
+    bool res8 = s1.new_gt({{x, 1}, {y, 1}}, 2, false, c3);
+    assert(res8);
+    bool res9 = s1.new_lt({{x, 1}, {y, -1}}, 1, false, c4);
+    assert(res9);
+    bool res10 = s1.new_lt({{y, 1}, {z, 1}}, 4, false, c5);
+    assert(res10);
+    std::stringstream ss1;
+    assert(s1.save(ss1, {c3, c4, c5}));
+    s1.retract(c5);
+    assert(s1.check());
+    ss1.str("");
+    assert(s1.save(ss1, {c3, c4, c5}));
+
+    linspire::solver r1s;
+    linspire::constraint r3, r4, r5;
+    assert(r1s.load(ss1, {r3, r4, r5}));
+    for (utils::var v = 0; v <= z + 3; ++v)
+    {
+        assert(r1s.val(v) == s1.val(v));
+        assert(r1s.lb(v) == s1.lb(v));
+        assert(r1s.ub(v) == s1.ub(v));
+    }
+    // the retracted constraint is reactivated over the restored basis..
+    bool res11 = r1s.add_constraint(r5);
+    assert(res11);
+    bool res12 = r1s.new_gt({{z, 1}}, 3);
+    assert(res12);
+    assert(r1s.check());
+    assert(r1s.val(y) + r1s.val(z) <= 4);
+    assert(r1s.val(x) + r1s.val(y) >= 2);
+}
+
+void test_clone_and_warm_start()
+{
+    const auto build = [](linspire::solver &s, linspire::constraint &c0, linspire::constraint &c1)
+    {
+        auto x = s.new_var();
+        auto y = s.new_var();
+        // x + y >= 2, x - y <= 1, y <= 4, 2x + y >= 5
+        bool res0 = s.new_gt({{x, 1}, {y, 1}}, 2, false, c0);
+        assert(res0);
+        bool res1 = s.new_lt({{x, 1}, {y, -1}}, 1, false, c1);
+        assert(res1);
+        bool res2 = s.new_lt({{y, 1}}, 4);
+        assert(res2);
+        bool res3 = s.new_gt({{x, 2}, {y, 1}}, 5);
+        assert(res3);
+    };
+    linspire::solver s;
+    linspire::constraint c0, c1;
+    build(s, c0, c1);
+    assert(s.check());
+    const utils::var x = 0, y = 1;
+
+    linspire::solver c;
+    linspire::constraint d0, d1;
+    const auto before = s.memory_usage();
+    assert(before.shared == 0);
+    assert(!s.clone(c, {c0}, {d0})); // the reason `c1` is missing..
+    assert(s.clone(c, {c0, c1}, {d0, d1}));
+    assert(!s.clone(c, {c0, c1}, {d0, d1})); // the clone is not empty anymore..
+    for (utils::var v = 0; v < s.snapshot().size(); ++v)
+    {
+        assert(c.val(v) == s.val(v));
+        assert(c.lb(v) == s.lb(v));
+        assert(c.ub(v) == s.ub(v));
+    }
+
+    // the tableau and the expressions are shared by the two solvers, rather than copied..
+    const auto s_mem = s.memory_usage();
+    const auto c_mem = c.memory_usage();
+    assert(s_mem.shared > 0);
+    assert(c_mem.shared == s_mem.shared);
+    assert(s_mem.tableau + s_mem.exprs + s_mem.shared == before.tableau + before.exprs);
+    assert(c_mem.tableau + c_mem.exprs < before.tableau + before.exprs);
+
+    // the clone evolves on its own, with its own constraints..
+    const auto x_val = s.val(x);
+    bool res4 = c.new_gt({{x, 1}}, 3);
+    assert(res4);
+    c.retract(d1);
+    assert(c.check());
+    assert(c.val(x) >= 3);
+    assert(c.val(x) + c.val(y) >= 2);
+    assert(s.val(x) == x_val);
+    assert(s.lb(x) < 3);
+    assert(s.check());
+    assert(c.memory_usage().shared < c_mem.shared); // the clone has got its own tableau..
+
+    // a solver built from scratch starts from the feasible assignment of `s`..
+    linspire::solver w;
+    linspire::constraint e0, e1;
+    build(w, e0, e1);
+    w.warm_start(s);
+    for (utils::var v = 0; v < s.snapshot().size(); ++v)
+        assert(w.val(v) == s.val(v));
+#ifdef LINSPIRE_ENABLE_STATISTICS
+    const auto n_pivots = w.stats().n_pivots;
+    assert(w.check());
+    assert(w.stats().n_pivots == n_pivots); // the check needs no pivots..
+#else
+    assert(w.check());
+#endif
+}
+
+void test_optimization()
+{
+    linspire::solver s;
+    auto x = s.new_var();
+    auto y = s.new_var();
+
+    // x + y >= 2, x - y <= 1
+    bool res0 = s.new_gt({{x, 1}, {y, 1}}, 2);
+    assert(res0);
+    bool res1 = s.new_lt({{x, 1}, {y, -1}}, 1);
+    assert(res1);
+    const auto min_x = s.minimize({{x, 1}});
+    assert(min_x && *min_x == utils::rational::negative_infinite);
+
+    // y <= 4, y - x <= 3
+    bool res2 = s.new_lt({{y, 1}}, 4);
+    assert(res2);
+    bool res3 = s.new_lt({{y, 1}, {x, -1}}, 3);
+    assert(res3);
+    const auto max_x = s.maximize({{x, 1}});
+    assert(max_x && *max_x == 5);
+    assert(s.val(x) == 5 && s.val(y) == 4);
+    const auto min_sum = s.minimize({{x, 1}, {y, 1}});
+    assert(min_sum && *min_sum == 2);
+    assert(s.val(x) + s.val(y) == 2);
+    assert(s.val(x) >= -1); // the assignment is still feasible..
+    assert(s.val(x) - s.val(y) <= 1);
+    assert(s.val(y) - s.val(x) <= 3);
+
+    // the supremum over a strict bound is infinitesimally close to the bound..
+    bool res4 = s.new_lt({{x, 1}}, 3, true);
+    assert(res4);
+    const auto max_strict = s.maximize({{x, 1}});
+    assert(max_strict && *max_strict == utils::inf_rational(utils::rational(3), utils::rational(-1)));
+    assert(s.check());
+
+    // x >= 4 makes the constraints inconsistent..
+    bool res5 = s.new_gt({{x, 1}}, 4);
+    assert(!res5 || !s.minimize({{x, 1}}));
+}
+
+void test_compact()
+{
+    linspire::solver s;
+    auto x = s.new_var();
+    auto y = s.new_var();
+
+    // x + y >= 2, x - y <= 1, y <= 4
+    linspire::constraint c0;
+    bool res0 = s.new_gt({{x, 1}, {y, 1}}, 2, false, c0);
+    assert(res0);
+    bool res1 = s.new_lt({{x, 1}, {y, -1}}, 1);
+    assert(res1);
+    bool res2 = s.new_lt({{y, 1}}, 4);
+    assert(res2);
+    assert(s.check());
+    const auto x_val = s.val(x);
+    const auto y_val = s.val(y);
+
+    s.retract(c0);
+    const auto pool = linspire::block_pool::get<sizeof(std::pair<const utils::var, utils::inf_rational>)>();
+    const auto n_free = pool->free_blocks();
+    assert(n_free > 0); // the node of the retracted bound is cached..
+    s.compact();
+    assert(s.val(x) == x_val);
+    assert(s.val(y) == y_val);
+    assert(pool->free_blocks() == n_free); // the pools are shared by the other solvers of the thread, hence they are left untouched..
+    linspire::block_pool::release_all();
+    assert(pool->free_blocks() == 0);
+
+    // the solver keeps working after the compaction..
+    bool res3 = s.add_constraint(c0);
+    assert(res3);
+    bool res4 = s.new_gt({{x, 1}}, 2);
+    assert(res4);
+    assert(s.check());
+    assert(s.val(x) + s.val(y) >= 2);
+    assert(s.val(x) - s.val(y) <= 1);
+}
+
+void test_check_budget()
+{
+    const auto build = [](linspire::solver &s)
+    {
+        auto x = s.new_var();
+        auto y = s.new_var();
+        auto z = s.new_var();
+        // x + y + z >= 6, x + 2y <= 8, 2y + z >= 5, x - z >= 1
+        bool res0 = s.new_gt({{x, 1}, {y, 1}, {z, 1}}, 6);
+        assert(res0);
+        bool res1 = s.new_lt({{x, 1}, {y, 2}}, 8);
+        assert(res1);
+        bool res2 = s.new_gt({{y, 2}, {z, 1}}, 5);
+        assert(res2);
+        bool res3 = s.new_gt({{x, 1}, {z, -1}}, 1);
+        assert(res3);
+    };
+
+    // without pivots, nothing can be concluded..
+    linspire::solver s;
+    build(s);
+    linspire::check_budget none;
+    none.max_pivots = 0;
+    assert(s.check(none) == linspire::check_result::unknown);
+
+    // the procedure resumes from where it stopped, one pivot at a time..
+    linspire::check_budget one;
+    one.max_pivots = 1;
+    std::size_t n_calls = 0;
+    auto res = linspire::check_result::unknown;
+    while (res == linspire::check_result::unknown)
+    {
+        res = s.check(one);
+        ++n_calls;
+    }
+    assert(res == linspire::check_result::sat);
+    assert(n_calls > 1);
+    const utils::var x = 0, y = 1, z = 2;
+    assert(s.val(x) + s.val(y) + s.val(z) >= 6);
+    assert(s.val(x) + s.val(y) + s.val(y) <= 8);
+    assert(s.val(y) + s.val(y) + s.val(z) >= 5);
+    assert(s.val(x) - s.val(z) >= 1);
+    assert(s.check(none) == linspire::check_result::sat); // nothing is left to do..
+
+    // a cancelled or expired check stops before pivoting..
+    linspire::solver c;
+    build(c);
+    std::atomic<bool> cancel{true};
+    linspire::check_budget cancelled;
+    cancelled.cancel = &cancel;
+    assert(c.check(cancelled) == linspire::check_result::unknown);
+    linspire::check_budget expired;
+    expired.deadline = std::chrono::steady_clock::now();
+    assert(c.check(expired) == linspire::check_result::unknown);
+    cancel = false;
+    assert(c.check(cancelled) == linspire::check_result::sat);
+
+    // x <= 1 makes the constraints inconsistent, which is detected within the budget as well..
+    linspire::constraint c4;
+    bool res4 = c.new_lt({{x, 1}}, 1, false, c4);
+    res = res4 ? linspire::check_result::unknown : linspire::check_result::unsat;
+    while (res == linspire::check_result::unknown)
+        res = c.check(one);
+    assert(res == linspire::check_result::unsat);
+    assert(!res4 || c.get_conflict().size() == 1); // the other constraints have no reasons..
+}
+
+void test_batched_queries()
+{
+    linspire::solver s;
+    auto x = s.new_var();
+    auto y = s.new_var();
+    auto z = s.new_var();
+    // 0 <= x <= 4, 1 <= y <= 3, x + y <= 5 (the implied bounds of the slack variable are resolved once)
+    bool res0 = s.new_gt({{x, 1}}, 0);
+    assert(res0);
+    bool res1 = s.new_lt({{x, 1}}, 4);
+    assert(res1);
+    bool res2 = s.new_gt({{y, 1}}, 1);
+    assert(res2);
+    bool res3 = s.new_lt({{y, 1}}, 3);
+    assert(res3);
+    bool res4 = s.new_lt({{x, 1}, {y, 1}}, 5);
+    assert(res4);
+    assert(s.check());
+
+    std::vector<utils::lin> ls;
+    for (int i = 0; i < 1000; ++i)
+    { // enough expressions to be split among the threads..
+        utils::lin l(utils::rational(i % 3));
+        l.vars.emplace(x, utils::rational(i % 7 - 3));
+        l.vars.emplace(y, utils::rational(i % 5 - 2));
+        if (i % 10 == 0)
+            l.vars.emplace(z, utils::rational::one); // the unbounded variable..
+        ls.push_back(std::move(l));
+    }
+    ls.push_back(utils::lin{{x, 1}, {y, 1}});
+    for (const std::size_t n_threads : {std::size_t(1), std::size_t(4)})
+    {
+        const auto bs = s.bounds(ls, n_threads);
+        const auto vs = s.vals(ls, n_threads);
+        assert(bs.size() == ls.size() && vs.size() == ls.size());
+        for (std::size_t i = 0; i < ls.size(); ++i)
+        {
+            assert(bs[i].first == s.lb(ls[i]));
+            assert(bs[i].second == s.ub(ls[i]));
+            assert(vs[i] == s.val(ls[i]));
+        }
+    }
+
+    std::vector<std::pair<utils::lin, utils::lin>> ps;
+    for (std::size_t i = 0; i + 1 < ls.size(); i += 2)
+        ps.emplace_back(ls[i], ls[i + 1]);
+    ps.emplace_back(utils::lin{{x, 1}}, utils::lin(utils::rational(5)));
+    ps.emplace_back(utils::lin{{y, 1}}, utils::lin(utils::rational(2)));
+    for (const std::size_t n_threads : {std::size_t(1), std::size_t(4)})
+    {
+        const auto ms = s.match(ps, n_threads);
+        assert(ms.size() == ps.size());
+        for (std::size_t i = 0; i < ps.size(); ++i)
+            assert(ms[i] == s.match(ps[i].first, ps[i].second));
+        assert(!ms[ms.size() - 2]); // x <= 4 cannot be 5..
+        assert(ms.back());          // 1 <= y <= 3 can be 2..
+    }
+}
+
+void test_portfolio_check()
+{
+    linspire::solver s;
+    auto x = s.new_var();
+    auto y = s.new_var();
+    auto z = s.new_var();
+    linspire::constraint c0, c1, c2, c3, c4;
+    const std::vector<std::reference_wrapper<const linspire::constraint>> cs{c0, c1, c2, c3, c4};
+    // x + y + z >= 6, x + 2y <= 8, 2y + z >= 5, x - z >= 1
+    bool res0 = s.new_gt({{x, 1}, {y, 1}, {z, 1}}, 6, false, c0);
+    assert(res0);
+    bool res1 = s.new_lt({{x, 1}, {y, 2}}, 8, false, c1);
+    assert(res1);
+    bool res2 = s.new_gt({{y, 2}, {z, 1}}, 5, false, c2);
+    assert(res2);
+    bool res3 = s.new_gt({{x, 1}, {z, -1}}, 1, false, c3);
+    assert(res3);
+
+    const std::vector<linspire::pivot_rule> rules{{linspire::leaving_rule::bland, linspire::entering_rule::bland, 100},
+                                                  {linspire::leaving_rule::max_violation, linspire::entering_rule::min_occurrences, 100},
+                                                  {linspire::leaving_rule::least_infeasibility, linspire::entering_rule::greatest_slack, 100},
+                                                  {linspire::leaving_rule::max_violation, linspire::entering_rule::steepest_edge, 100}};
+    assert(s.check(rules, cs));
+    assert(s.val(x) + s.val(y) + s.val(z) >= 6);
+    assert(s.val(x) + s.val(y) + s.val(y) <= 8);
+    assert(s.val(y) + s.val(y) + s.val(z) >= 5);
+    assert(s.val(x) - s.val(z) >= 1);
+    assert(s.get_pivot_rule().leaving == linspire::leaving_rule::bland); // the rule of the solver is restored..
+    assert(s.check());
+
+    // x <= 1 makes the constraints inconsistent, and the explanation refers to the constraints of `s`..
+    bool res4 = s.new_lt({{x, 1}}, 1, false, c4);
+    if (res4)
+    {
+        assert(!s.check(rules, cs));
+        const auto &cnfl = s.get_conflict();
+        assert(!cnfl.empty());
+        assert(cnfl.size() == s.get_conflict_coefficients().size());
+        for (const auto &c : cnfl)
+            assert(std::any_of(cs.begin(), cs.end(), [&c](const auto &d)
+                               { return &c.get() == &d.get(); }));
+    }
+
+    // without the missing reasons the state cannot be cloned, and the check runs on the solver alone..
+    s.retract(c4);
+    assert(s.check(rules, {c0}));
+    assert(s.val(x) - s.val(z) >= 1);
+}
+
+void test_memory_usage()
+{
+    linspire::solver s;
+    const auto empty = s.memory_usage();
+    assert(empty.row_density.empty());
+
+    std::vector<utils::var> xs;
+    for (int i = 0; i < 8; ++i)
+        xs.push_back(s.new_var());
+    // x0 + x1 >= 1, x0 + x1 + x2 >= 1, x0 + ... + x7 >= 1 (rows with 2, 3 and 8 terms)
+    bool res0 = s.new_gt({{xs[0], 1}, {xs[1], 1}}, 1);
+    assert(res0);
+    bool res1 = s.new_gt({{xs[0], 1}, {xs[1], 1}, {xs[2], 1}}, 1);
+    assert(res1);
+    utils::lin l;
+    for (const auto x : xs)
+        l.vars.emplace(x, utils::rational::one);
+    bool res2 = s.new_gt(l, 1);
+    assert(res2);
+
+    const auto r = s.memory_usage();
+    assert(r.vars > empty.vars);
+    assert(r.tableau > empty.tableau);
+    assert(r.exprs > empty.exprs);
+    assert(r.total() > empty.total());
+    assert(r.row_density.size() == 4);
+    assert(r.row_density[0] == 0 && r.row_density[1] == 2 && r.row_density[2] == 0 && r.row_density[3] == 1);
+
+    // the unused capacity released by `compact` is no longer accounted..
+    s.compact();
+    assert(s.memory_usage().total() <= r.total());
+}
+
+void test_gc()
+{
+    linspire::solver s;
+    auto x = s.new_var();
+    auto y = s.new_var();
+
+    // x + y <= 4, x - y >= 1, x >= 3
+    linspire::constraint c0, c1, c2;
+    bool res0 = s.new_lt({{x, 1}, {y, 1}}, 4, false, c0);
+    assert(res0);
+    bool res1 = s.new_gt({{x, 1}, {y, -1}}, 1, false, c1);
+    assert(res1);
+    bool res2 = s.new_gt({{x, 1}}, 3, false, c2);
+    assert(res2);
+    assert(s.check());
+
+    // retracting `c0` leaves `x + y` unbounded, hence its row leaves the tableau, while re-adding the constraint brings it back..
+    s.retract(c0);
+    assert(s.check());
+    bool res3 = s.add_constraint(c0);
+    assert(res3);
+    assert(s.check());
+    assert(s.val(x) + s.val(y) <= 4);
+
+    // a new constraint on the same expression reactivates the row as well, even within a backtracking point..
+    s.retract(c0);
+    s.push();
+    linspire::constraint c3;
+    bool res4 = s.new_lt({{x, 1}, {y, 1}}, 2, false, c3);
+    assert(res4);
+    assert(s.check());
+    assert(s.val(x) + s.val(y) <= 2);
+    s.retract(c3);
+    assert(s.gc() == 0); // the trail might refer to the slack variables..
+    s.pop();
+
+    // nothing refers to the slack variable of `x + y` anymore, hence its identifier is reused..
+    assert(s.gc() == 1);
+    auto z = s.new_var();
+    assert(z == 2);
+    assert(s.lb(z) == utils::rational::negative_infinite);
+    assert(s.ub(z) == utils::rational::positive_infinite);
+    bool res5 = s.new_lt({{z, 1}, {x, -1}}, -1);
+    assert(res5);
+    assert(s.check());
+    assert(s.val(x) - s.val(y) >= 1);
+    assert(s.val(x) >= 3);
+    assert(s.val(z) <= s.val(x) - 1);
+    assert(s.gc() == 0);
+}
+
+void test_release_and_renumber()
+{
+    linspire::solver s;
+    auto x = s.new_var();
+    auto y = s.new_var();
+    auto z = s.new_var();
+
+    // x + y >= 2, y - z <= 1
+    linspire::constraint c0, c1;
+    bool res0 = s.new_gt({{x, 1}, {y, 1}}, 2, false, c0);
+    assert(res0);
+    bool res1 = s.new_lt({{y, 1}, {z, -1}}, 1, false, c1);
+    assert(res1);
+    assert(s.check());
+    const utils::var s0 = 3; // the slack variable of `x + y`..
+
+    // the slack variables of the constraints are reclaimed by `gc`, the others are released explicitly..
+    assert(!s.release(s0));
+    const auto x_val = s.val(x);
+    assert(s.release(x));
+    assert(s.lb(x) == x_val && s.ub(x) == x_val); // `x + y` still mentions `x`, which is hence fixed..
+    assert(s.gc() == 0);
+    assert(s.check());
+    assert(s.val(x) + s.val(y) >= 2);
+
+    // a variable defined by an expression loses its row..
+    auto w = s.new_var(utils::lin{{y, 1}, {z, 1}});
+    assert(s.release(w));
+    assert(!s.release(w)); // already released..
+
+    // once `x + y` is retracted, nothing mentions `x` anymore..
+    s.retract(c0);
+    assert(s.gc() == 3);
+
+    assert(!s.renumber({})); // the reason `c1` is missing..
+    const auto remap = s.renumber({c0, c1});
+    assert(remap);
+    assert(remap->size() == 5); // the trailing identifier of `w` has already been dropped by `gc`..
+    assert((*remap)[x] == linspire::solver::npos && (*remap)[s0] == linspire::solver::npos);
+    assert((*remap)[y] == 0 && (*remap)[z] == 1 && (*remap)[4] == 2);
+    assert(s.snapshot().size() == 3);
+
+    // the constraints, the tableau and the difference graph follow the new identifiers..
+    const utils::var n_y = 0, n_z = 1;
+    assert(s.check());
+    assert(s.val(n_y) - s.val(n_z) <= 1);
+    bool res2 = s.new_gt({{n_y, 1}}, 5);
+    bool res3 = res2 && s.new_lt({{n_z, 1}}, 0);
+    assert(!res3 || !s.check());
+    assert(!s.get_conflict().empty());
+    assert(&s.get_conflict().front().get() == &c1);
+    s.retract(c1);
+    assert(s.check());
+    assert(s.val(n_y) >= 5 && s.val(n_z) <= 0);
+}
+
+#ifdef LINSPIRE_ENABLE_STATISTICS
+void test_statistics()
+{
+    linspire::solver s;
+    auto x = s.new_var();
+    auto y = s.new_var();
+
+    // x + y >= 2, x - y >= 1, x <= 3, x + y >= 1
+    bool res0 = s.new_gt({{x, 1}, {y, 1}}, 2);
+    assert(res0);
+    bool res1 = s.new_gt({{x, 1}, {y, -1}}, 1);
+    assert(res1);
+    bool res2 = s.new_lt({{x, 1}}, 3);
+    assert(res2);
+    bool res3 = s.new_gt({{x, 1}, {y, 1}}, 1); // reuses the slack variable of `x + y`..
+    assert(res3);
+    assert(s.check());
+    assert(s.check());
+
+    auto st = s.stats();
+    assert(st.n_checks == 2);
+    assert(st.n_pivots > 0);
+    assert(st.n_reused_slacks == 1);
+    assert(st.n_conflicts == 0);
+    assert(st.max_row_length == 2);
+    assert(st.avg_row_length == 2);
+
+    // x - y <= 0 makes the constraints inconsistent
+    bool res4 = s.new_lt({{x, 1}, {y, -1}}, 0);
+    assert(!res4 || !s.check());
+    assert(s.stats().n_conflicts == 1);
+}
+#endif
+
 int main()
 {
     test_basic_eq_and_lt();
@@ -302,8 +1999,43 @@ int main()
     test_add_retract_readd_constraint();
     test_constant_inequality_strictness();
     test_slack_variable_reuse_for_duplicate_expression();
+    test_normalized_expressions();
     test_expression_bounds_and_match();
     test_add_constraint_inconsistency_detection();
+    test_incremental_violation_tracking();
+    test_implied_bounds_cache_invalidation();
+    test_pivot_rules();
+    test_flat_tableau_pivot();
+    test_arith_fast_path();
+    test_float_presolve();
+    test_fixed_elimination();
+    test_expr_table();
+    test_push_pop();
+    test_batch_ingestion();
+    test_bound_stack();
+    test_farkas_conflict();
+    test_propagate();
+#ifdef LINSPIRE_ENABLE_LISTENERS
+    test_deferred_notifications();
+#endif
+    test_difference_logic();
+    test_snapshot();
+#ifdef LINSPIRE_ENABLE_TRACE
+    test_trace();
+#endif
+    test_optimization();
+    test_save_load();
+    test_clone_and_warm_start();
+    test_compact();
+    test_gc();
+    test_check_budget();
+    test_batched_queries();
+    test_portfolio_check();
+    test_memory_usage();
+    test_release_and_renumber();
+#ifdef LINSPIRE_ENABLE_STATISTICS
+    test_statistics();
+#endif
 
     return 0;
 }